@@ -16,13 +16,10 @@
 #include <random>
 
 /* Keyple Core Util */
-#include "Arrays.h"
 #include "IllegalStateException.h"
-#include "InterruptedException.h"
-#include "System.h"
-#include "Thread.h"
 
 /* Keyple Service Resource */
+#include "KeypleServiceResourceLog.h"
 #include "ReaderManagerAdapter.h"
 
 /* Keyple Core Service */
@@ -39,14 +36,90 @@ using namespace keyple::core::util::cpp;
 using namespace keyple::core::util::cpp::exception;
 
 using AllocationStrategy = PluginsConfigurator::AllocationStrategy;
+using FreeCardResourceIterator = std::map<uint64_t, std::shared_ptr<CardResource>>::iterator;
+
+/* SELECTION POLICIES ------------------------------------------------------------------------- */
+
+struct CardProfileManagerAdapter::FirstPolicy {
+    static FreeCardResourceIterator select(CardProfileManagerAdapter& manager)
+    {
+        return manager.mFreeCardResources.begin();
+    }
+};
+
+struct CardProfileManagerAdapter::CyclicPolicy {
+    static FreeCardResourceIterator select(CardProfileManagerAdapter& manager)
+    {
+        /* The next free card resource after the cursor, or the first one (wrap around) */
+        const auto it = manager.mFreeCardResources.upper_bound(manager.mCyclicCursor);
+
+        return it != manager.mFreeCardResources.end() ? it : manager.mFreeCardResources.begin();
+    }
+};
+
+struct CardProfileManagerAdapter::RandomPolicy {
+    static FreeCardResourceIterator select(CardProfileManagerAdapter& manager)
+    {
+        /* Seeded once per thread, no shared state is modified by the draw */
+        static thread_local std::mt19937 randomEngine(std::random_device{}());
+
+        std::uniform_int_distribution<std::size_t> distribution(
+            0, manager.mFreeCardResourceHeap.size() - 1);
+
+        return manager.mFreeCardResourceHeap[distribution(randomEngine)].mIterator;
+    }
+};
+
+struct CardProfileManagerAdapter::PriorityPolicy {
+    static FreeCardResourceIterator select(CardProfileManagerAdapter& manager)
+    {
+        /* The top of the heap */
+        return manager.mFreeCardResourceHeap.front().mIterator;
+    }
+};
+
+/* CARD PROFILE MANAGER ADAPTER --------------------------------------------------------------- */
 
 CardProfileManagerAdapter::CardProfileManagerAdapter(
   std::shared_ptr<CardResourceProfileConfigurator> cardProfile,
   std::shared_ptr<CardResourceServiceConfiguratorAdapter> globalConfiguration)
 : mCardProfile(cardProfile),
   mGlobalConfiguration(globalConfiguration),
-  mService(CardResourceServiceAdapter::getInstance())
+  mService(CardResourceServiceAdapter::getInstance()),
+  mNextRank(1),
+  mCyclicCursor(0),
+  mAvailabilitySequence(0),
+  mIsAsyncWaitersMonitorRunning(false),
+  mAllocationCount(0),
+  mAllocationFailureCount(0),
+  mAllocationTimeoutCount(0),
+  mIsStopping(false)
 {
+    /* Bind the selection policy once for all */
+    if (globalConfiguration->getAllocationStrategySpi() != nullptr) {
+        mGetRegularCardResource = &CardProfileManagerAdapter::getCustomCardResource;
+    } else {
+        switch (globalConfiguration->getAllocationStrategy()) {
+        case AllocationStrategy::CYCLIC:
+            mGetRegularCardResource =
+                &CardProfileManagerAdapter::getRegularCardResource<CyclicPolicy>;
+            break;
+        case AllocationStrategy::RANDOM:
+            mGetRegularCardResource =
+                &CardProfileManagerAdapter::getRegularCardResource<RandomPolicy>;
+            break;
+        case AllocationStrategy::LEAST_RECENTLY_USED:
+        case AllocationStrategy::LEAST_LOADED:
+            mGetRegularCardResource =
+                &CardProfileManagerAdapter::getRegularCardResource<PriorityPolicy>;
+            break;
+        default:
+            mGetRegularCardResource =
+                &CardProfileManagerAdapter::getRegularCardResource<FirstPolicy>;
+            break;
+        }
+    }
+
     /* Prepare filter on reader name if requested */
     if (cardProfile->getReaderNameRegex() != "") {
         mReaderNameRegexPattern = Pattern::compile(cardProfile->getReaderNameRegex());
@@ -54,149 +127,590 @@ CardProfileManagerAdapter::CardProfileManagerAdapter(
         mReaderNameRegexPattern = nullptr;
     }
 
-    /* Initialize all available card resources */
+    /* Initialize the plugins to use, the card resources are probed by the service */
     if (!cardProfile->getPlugins().empty()) {
-        initializeCardResourcesUsingProfilePlugins();
+        initializePluginsUsingProfilePlugins();
     } else {
-        initializeCardResourcesUsingDefaultPlugins();
+        initializePluginsUsingDefaultPlugins();
+    }
+}
+
+CardProfileManagerAdapter::~CardProfileManagerAdapter()
+{
+    stop();
+}
+
+void CardProfileManagerAdapter::stop()
+{
+    std::vector<std::shared_ptr<Waiter>> asyncWaiters;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+
+        for (auto it = mWaiters.begin(); it != mWaiters.end();) {
+            if ((*it)->mCallback) {
+                asyncWaiters.push_back(*it);
+                it = mWaiters.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    mAsyncWaitersChanged.notify_all();
+
+    if (mAsyncWaitersMonitor.joinable()) {
+        /*
+         * A callback completed by the monitor may itself reconfigure the service, the monitor
+         * holding a reference to the manager until it terminates.
+         */
+        if (mAsyncWaitersMonitor.get_id() == std::this_thread::get_id()) {
+            mAsyncWaitersMonitor.detach();
+        } else {
+            mAsyncWaitersMonitor.join();
+        }
+    }
+
+    for (const auto& waiter : asyncWaiters) {
+        complete(waiter->mCallback, nullptr);
     }
 }
 
 void CardProfileManagerAdapter::removeCardResource(std::shared_ptr<CardResource> cardResource)
 {
-    const auto it = std::find(mCardResources.begin(), mCardResources.end(), cardResource);
-    if (it != mCardResources.end()) {
-        mCardResources.erase(it);
-        mLogger->debug("Remove % from card resource profile '%'\n",
-                       CardResourceServiceAdapter::getCardResourceInfo(cardResource),
-                       mCardProfile->getProfileName());
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it = mCardResourceRanks.find(cardResource);
+    if (it != mCardResourceRanks.end()) {
+        removeFreeCardResource(it->second);
+        mCardResourceRanks.erase(it);
+        KEYPLESERVICERESOURCE_LOG_DEBUG(
+            mLogger,
+            "Remove % from card resource profile '%'\n",
+            CardResourceServiceAdapter::getCardResourceInfo(cardResource),
+            mCardProfile->getProfileName());
     }
 }
 
-void CardProfileManagerAdapter::onReaderConnected(
+bool CardProfileManagerAdapter::isReaderAccepted(
+    const std::shared_ptr<ReaderManagerAdapter>& readerManager) const
+{
+    return std::find(mPlugins.begin(), mPlugins.end(), readerManager->getPlugin()) !=
+               mPlugins.end() &&
+           isReaderAccepted(readerManager->getReader());
+}
+
+void CardProfileManagerAdapter::onReaderUnlocked(
     std::shared_ptr<ReaderManagerAdapter> readerManager)
 {
-    if (!mCardProfile->getPlugins().empty()) {
-        for (const auto& profilePlugin : mCardProfile->getPlugins()) {
-            if (profilePlugin == readerManager->getPlugin()) {
-                initializeCardResource(readerManager);
-                break;
+    const std::vector<std::shared_ptr<CardResource>> cardResources =
+        readerManager->getCardResources();
+
+    bool isCardResourceFreed = false;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        for (const auto& cardResource : cardResources) {
+            const auto it = mCardResourceRanks.find(cardResource);
+            if (it != mCardResourceRanks.end() &&
+                addFreeCardResource(it->second, cardResource, getPriority(readerManager))) {
+                isCardResourceFreed = true;
             }
         }
-    } else {
-        initializeCardResource(readerManager);
+    }
+
+    /* The waiters are not involved by a reader without card resource of the profile */
+    if (isCardResourceFreed) {
+        notifyCardResourceAvailable();
     }
 }
 
-void CardProfileManagerAdapter::onCardInserted(std::shared_ptr<ReaderManagerAdapter> readerManager)
+void CardProfileManagerAdapter::notifyCardResourceAvailable()
 {
-    onReaderConnected(readerManager);
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mAvailabilitySequence++;
+    }
+
+    mCardResourceAvailable.notify_all();
+
+    /* Waiting threads in fair mode and/or asynchronous requests */
+    serveWaiters();
 }
 
 std::shared_ptr<CardResource> CardProfileManagerAdapter::getCardResource()
+{
+    const std::chrono::steady_clock::time_point requestTime = std::chrono::steady_clock::now();
+
+    const std::shared_ptr<CardResource> cardResource =
+        mGlobalConfiguration->isBlockingAllocationMode() &&
+                mGlobalConfiguration->isFairAllocationMode()
+            ? getCardResourceFairly()
+            : getCardResourceUnfairly();
+
+    recordAllocation(requestTime, cardResource);
+
+    return cardResource;
+}
+
+std::shared_ptr<CardResource> CardProfileManagerAdapter::getCardResourceUnfairly()
 {
     std::shared_ptr<CardResource> cardResource = nullptr;
-    uint64_t maxTime = System::currentTimeMillis() + mGlobalConfiguration->getTimeoutMillis();
+    const std::chrono::steady_clock::time_point maxTime =
+        std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(mGlobalConfiguration->getTimeoutMillis());
 
     do {
-        if (!mPlugins.empty()) {
-            if (!mPoolPlugins.empty()) {
-                cardResource = getRegularOrPoolCardResource();
-            } else {
-                cardResource = getRegularCardResource();
-            }
-        } else {
-            cardResource = getPoolCardResource();
-        }
+        const uint64_t sequence = getAvailabilitySequence();
+
+        cardResource = tryGetCardResource();
 
-        pauseIfNeeded(cardResource);
+        pauseIfNeeded(cardResource, sequence, maxTime);
 
     } while (cardResource == nullptr &&
              mGlobalConfiguration->isBlockingAllocationMode() &&
-             System::currentTimeMillis() <= maxTime);
+             std::chrono::steady_clock::now() <= maxTime);
 
     return cardResource;
 }
 
-void CardProfileManagerAdapter::initializeCardResourcesUsingProfilePlugins()
+std::shared_ptr<CardResource> CardProfileManagerAdapter::getCardResourceFairly()
 {
-    for (const auto& plugin : mCardProfile->getPlugins()) {
-        const auto poolPlugin = std::dynamic_pointer_cast<PoolPlugin>(plugin);
-        if (poolPlugin) {
-            mPoolPlugins.push_back(poolPlugin);
-        } else {
-            mPlugins.push_back(plugin);
-            initializeCardResources(plugin);
+    const std::chrono::steady_clock::time_point maxTime =
+        std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(mGlobalConfiguration->getTimeoutMillis());
+
+    uint64_t sequence;
+    bool hasWaiters;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        sequence = mAvailabilitySequence;
+        hasWaiters = !mWaiters.empty();
+    }
+
+    /* A new request never overtakes the waiting ones */
+    if (!hasWaiters) {
+        std::shared_ptr<CardResource> cardResource = tryGetCardResource();
+        if (cardResource != nullptr) {
+            return cardResource;
+        }
+    }
+
+    auto waiter = std::make_shared<Waiter>();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWaiters.push_back(waiter);
+
+    /* A notification occurring before the registration of the waiter must not be missed */
+    bool isServingNeeded = mAvailabilitySequence != sequence;
+
+    while (waiter->mCardResource == nullptr) {
+        if (isServingNeeded) {
+            lock.unlock();
+            serveWaiters();
+            lock.lock();
+            isServingNeeded = false;
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() >= maxTime) {
+            mWaiters.erase(std::find(mWaiters.begin(), mWaiters.end(), waiter));
+            break;
+        }
+
+        if (!waiter->mCondition.wait_until(lock, getWakeUpTime(maxTime), [&] {
+                return waiter->mCardResource != nullptr;
+            })) {
+            /* The availability may have changed without notification: the oldest waiter polls */
+            isServingNeeded = mWaiters.front() == waiter;
         }
     }
+
+    return waiter->mCardResource;
 }
 
-void CardProfileManagerAdapter::initializeCardResourcesUsingDefaultPlugins()
+void CardProfileManagerAdapter::getCardResource(
+    std::function<void(std::shared_ptr<CardResource>)> callback)
 {
-    const auto& poolPlugins = mGlobalConfiguration->getPoolPlugins();
-    mPoolPlugins.insert(std::end(mPoolPlugins), std::begin(poolPlugins), std::end(poolPlugins));
+    /* The request is recorded when completed */
+    const std::chrono::steady_clock::time_point requestTime = std::chrono::steady_clock::now();
+    const std::function<void(std::shared_ptr<CardResource>)> recordingCallback =
+        [this, requestTime, callback](std::shared_ptr<CardResource> cardResource) {
+            recordAllocation(requestTime, cardResource);
+            callback(cardResource);
+        };
+
+    if (!mGlobalConfiguration->isBlockingAllocationMode()) {
+        complete(recordingCallback, tryGetCardResource());
+        return;
+    }
+
+    uint64_t sequence;
+    bool hasWaiters;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        sequence = mAvailabilitySequence;
+        hasWaiters = !mWaiters.empty();
+    }
+
+    /* In fair mode, a new request never overtakes the waiting ones */
+    if (!hasWaiters || !mGlobalConfiguration->isFairAllocationMode()) {
+        std::shared_ptr<CardResource> cardResource = tryGetCardResource();
+        if (cardResource != nullptr) {
+            complete(recordingCallback, cardResource);
+            return;
+        }
+    }
+
+    auto waiter = std::make_shared<Waiter>();
+    waiter->mCallback = recordingCallback;
+    waiter->mMaxTime = std::chrono::steady_clock::now() +
+                       std::chrono::milliseconds(mGlobalConfiguration->getTimeoutMillis());
+
+    bool isServingNeeded;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mIsStopping) {
+            /* The card profile has been removed from the service */
+            lock.unlock();
+            complete(recordingCallback, nullptr);
+            return;
+        }
+
+        mWaiters.push_back(waiter);
+
+        /* A notification occurring before the registration of the request must not be missed */
+        isServingNeeded = mAvailabilitySequence != sequence;
+
+        if (!mIsAsyncWaitersMonitorRunning) {
+            /* The previous monitor, if any, has already left its loop */
+            if (mAsyncWaitersMonitor.joinable()) {
+                mAsyncWaitersMonitor.join();
+            }
 
-    for (const auto& plugin : mGlobalConfiguration->getPlugins()) {
-        mPlugins.push_back(plugin);
-        initializeCardResources(plugin);
+            mAsyncWaitersMonitor = std::thread(&CardProfileManagerAdapter::monitorAsyncWaiters,
+                                               shared_from_this());
+            mIsAsyncWaitersMonitorRunning = true;
+        }
+    }
+
+    mAsyncWaitersChanged.notify_one();
+
+    if (isServingNeeded) {
+        serveWaiters();
     }
 }
 
-void CardProfileManagerAdapter::initializeCardResources(std::shared_ptr<Plugin> plugin)
+void CardProfileManagerAdapter::serveWaiters()
 {
-    for (const auto& reader : plugin->getReaders()) {
-        std::shared_ptr<ReaderManagerAdapter> readerManager = mService->getReaderManager(reader);
-        initializeCardResource(readerManager);
+    while (true) {
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            if (mWaiters.empty()) {
+                return;
+            }
+        }
+
+        std::shared_ptr<CardResource> cardResource = tryGetCardResource();
+        if (cardResource == nullptr) {
+            return;
+        }
+
+        std::shared_ptr<Waiter> waiter = nullptr;
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            if (!mWaiters.empty()) {
+                /* Hand over the card resource to the oldest waiter */
+                waiter = mWaiters.front();
+                mWaiters.pop_front();
+                waiter->mCardResource = cardResource;
+                waiter->mCondition.notify_one();
+            }
+        }
+
+        if (waiter == nullptr) {
+            /* All waiters gave up in the meantime */
+            mService->releaseCardResource(cardResource);
+            return;
+        }
+
+        /* Asynchronous requests are completed outside the lock */
+        if (waiter->mCallback) {
+            complete(waiter->mCallback, cardResource);
+        }
     }
 }
 
-void CardProfileManagerAdapter::initializeCardResource(
-    std::shared_ptr<ReaderManagerAdapter> readerManager)
+void CardProfileManagerAdapter::monitorAsyncWaiters()
 {
-    if (isReaderAccepted(readerManager->getReader())) {
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mIsStopping) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point maxTime =
+            std::chrono::steady_clock::time_point::max();
+        std::vector<std::shared_ptr<Waiter>> expiredWaiters;
+
+        for (auto it = mWaiters.begin(); it != mWaiters.end();) {
+            if ((*it)->mCallback && now >= (*it)->mMaxTime) {
+                expiredWaiters.push_back(*it);
+                it = mWaiters.erase(it);
+            } else {
+                if ((*it)->mCallback) {
+                    maxTime = std::min(maxTime, (*it)->mMaxTime);
+                }
+                ++it;
+            }
+        }
 
-        readerManager->activate();
+        if (!expiredWaiters.empty()) {
+            lock.unlock();
+            for (const auto& waiter : expiredWaiters) {
+                complete(waiter->mCallback, nullptr);
+            }
+            lock.lock();
+            continue;
+        }
 
-        std::shared_ptr<CardResource> cardResource =
-            readerManager->matches(mCardProfile->getCardResourceProfileExtension());
+        if (maxTime == std::chrono::steady_clock::time_point::max()) {
+            /* No more pending asynchronous request */
+            break;
+        }
 
-        /*
-         * The returned card resource may already be present in the current list if the service
-         * starts with an observable reader in which a card has been inserted.
-         */
-        if (cardResource != nullptr) {
-            if (!Arrays::contains(mCardResources, cardResource)) {
-                mCardResources.push_back(cardResource);
-                mLogger->debug("Add % to card resource profile '%'\n",
-                               CardResourceServiceAdapter::getCardResourceInfo(cardResource),
-                               mCardProfile->getProfileName());
-            } else {
-                mLogger->debug("% already present in card resource profile '%'\n",
-                                CardResourceServiceAdapter::getCardResourceInfo(cardResource),
-                                mCardProfile->getProfileName());
+        if (mAsyncWaitersChanged.wait_until(lock, getWakeUpTime(maxTime)) ==
+                std::cv_status::timeout &&
+            std::chrono::steady_clock::now() < maxTime) {
+            /* The availability may have changed without notification */
+            lock.unlock();
+            serveWaiters();
+            lock.lock();
+        }
+    }
+
+    mIsAsyncWaitersMonitorRunning = false;
+}
+
+void CardProfileManagerAdapter::complete(
+    const std::function<void(std::shared_ptr<CardResource>)>& callback,
+    std::shared_ptr<CardResource> cardResource)
+{
+    try {
+        callback(cardResource);
+        return;
+    } catch (const std::exception& e) {
+        mLogger->error("Card resource request completion failed for profile '%': %\n",
+                       mCardProfile->getProfileName(),
+                       e.what());
+    } catch (...) {
+        mLogger->error("Card resource request completion failed for profile '%'\n",
+                       mCardProfile->getProfileName());
+    }
+
+    /* Not delivered, the card resource would otherwise remain allocated forever */
+    if (cardResource != nullptr) {
+        try {
+            mService->releaseCardResource(cardResource);
+        } catch (const std::exception& releaseException) {
+            mLogger->error("Unable to release the undelivered %: %\n",
+                           CardResourceServiceAdapter::getCardResourceInfo(cardResource),
+                           releaseException.what());
+        }
+    }
+}
+
+void CardProfileManagerAdapter::waitForCardResources(
+    const std::size_t count, const std::chrono::steady_clock::time_point maxTime)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    mCardResourceAvailable.wait_until(lock, getWakeUpTime(maxTime), [&] {
+        return mFreeCardResources.size() >= count;
+    });
+}
+
+std::shared_ptr<CardResource> CardProfileManagerAdapter::tryGetCardResource()
+{
+    if (!mPlugins.empty()) {
+        if (!mPoolPlugins.empty()) {
+            return getRegularOrPoolCardResource();
+        } else {
+            return (this->*mGetRegularCardResource)();
+        }
+    } else {
+        return getPoolCardResource();
+    }
+}
+
+std::vector<std::shared_ptr<ReaderManagerAdapter>>
+    CardProfileManagerAdapter::getAcceptedReaderManagers() const
+{
+    std::vector<std::shared_ptr<ReaderManagerAdapter>> readerManagers;
+
+    for (const auto& plugin : mPlugins) {
+        for (const auto& reader : plugin->getReaders()) {
+            std::shared_ptr<ReaderManagerAdapter> readerManager =
+                mService->getReaderManager(reader);
+            if (readerManager != nullptr && isReaderAccepted(reader)) {
+                readerManagers.push_back(readerManager);
             }
         }
     }
+
+    return readerManagers;
+}
+
+std::shared_ptr<CardResource> CardProfileManagerAdapter::probeReader(
+    std::shared_ptr<ReaderManagerAdapter> readerManager)
+{
+    readerManager->activate();
+
+    return readerManager->matches(mCardProfile->getCardResourceProfileExtension());
+}
+
+void CardProfileManagerAdapter::addCardResource(
+    std::shared_ptr<ReaderManagerAdapter> readerManager, std::shared_ptr<CardResource> cardResource)
+{
+    addCardResource(readerManager, cardResource, 0);
+}
+
+void CardProfileManagerAdapter::addCardResource(
+    std::shared_ptr<ReaderManagerAdapter> readerManager,
+    std::shared_ptr<CardResource> cardResource,
+    const uint64_t rank)
+{
+    /*
+     * The card resource may already be present in the current list if the service starts with an
+     * observable reader in which a card has been inserted.
+     */
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        const auto it = mCardResourceRanks.find(cardResource);
+        if (it == mCardResourceRanks.end()) {
+            const uint64_t cardResourceRank = rank != 0 ? rank : mNextRank;
+            mNextRank = std::max(mNextRank, cardResourceRank + 1);
+            mCardResourceRanks.insert({cardResource, cardResourceRank});
+            addFreeCardResource(cardResourceRank, cardResource, getPriority(readerManager));
+            mService->registerCardResource(cardResource, mCardProfile->getProfileName());
+            KEYPLESERVICERESOURCE_LOG_DEBUG(
+                mLogger,
+                "Add % to card resource profile '%'\n",
+                CardResourceServiceAdapter::getCardResourceInfo(cardResource),
+                mCardProfile->getProfileName());
+        } else {
+            addFreeCardResource(it->second, cardResource, getPriority(readerManager));
+            KEYPLESERVICERESOURCE_LOG_DEBUG(
+                mLogger,
+                "% already present in card resource profile '%'\n",
+                CardResourceServiceAdapter::getCardResourceInfo(cardResource),
+                mCardProfile->getProfileName());
+        }
+    }
+
+    /* The card resource is either new or has just been unlocked by the match process */
+    notifyCardResourceAvailable();
+}
+
+void CardProfileManagerAdapter::recordAllocation(
+    const std::chrono::steady_clock::time_point requestTime,
+    const std::shared_ptr<CardResource>& cardResource)
+{
+    mAcquireWaitTimeHistogram.record(std::chrono::steady_clock::now() - requestTime);
+
+    if (cardResource != nullptr) {
+        mAllocationCount++;
+    } else if (mGlobalConfiguration->isBlockingAllocationMode()) {
+        mAllocationTimeoutCount++;
+    } else {
+        mAllocationFailureCount++;
+    }
+}
+
+CardResourceServiceMetrics::ProfileMetrics CardProfileManagerAdapter::getMetrics()
+{
+    std::size_t cardResourceCount;
+    std::size_t freeCardResourceCount;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        cardResourceCount = mCardResourceRanks.size();
+        freeCardResourceCount = mFreeCardResources.size();
+    }
+
+    return CardResourceServiceMetrics::ProfileMetrics(mCardProfile->getProfileName(),
+                                                      cardResourceCount,
+                                                      freeCardResourceCount,
+                                                      mAllocationCount,
+                                                      mAllocationFailureCount,
+                                                      mAllocationTimeoutCount,
+                                                      mAcquireWaitTimeHistogram.getSnapshot(),
+                                                      mPoolAllocationTimeHistogram.getSnapshot());
 }
 
-bool CardProfileManagerAdapter::isReaderAccepted(std::shared_ptr<CardReader> reader)
+void CardProfileManagerAdapter::initializePluginsUsingProfilePlugins()
+{
+    for (const auto& plugin : mCardProfile->getPlugins()) {
+        const auto poolPlugin = std::dynamic_pointer_cast<PoolPlugin>(plugin);
+        if (poolPlugin) {
+            mPoolPlugins.push_back(poolPlugin);
+        } else {
+            mPlugins.push_back(plugin);
+        }
+    }
+}
+
+void CardProfileManagerAdapter::initializePluginsUsingDefaultPlugins()
+{
+    const auto& poolPlugins = mGlobalConfiguration->getPoolPlugins();
+    mPoolPlugins.insert(std::end(mPoolPlugins), std::begin(poolPlugins), std::end(poolPlugins));
+
+    const auto& plugins = mGlobalConfiguration->getPlugins();
+    mPlugins.insert(std::end(mPlugins), std::begin(plugins), std::end(plugins));
+}
+
+bool CardProfileManagerAdapter::isReaderAccepted(std::shared_ptr<CardReader> reader) const
 {
     return mReaderNameRegexPattern == nullptr ||
            mReaderNameRegexPattern->matcher(reader->getName())->matches();
 }
 
-void CardProfileManagerAdapter::pauseIfNeeded(std::shared_ptr<CardResource> cardResource)
+uint64_t CardProfileManagerAdapter::getAvailabilitySequence()
+{
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    return mAvailabilitySequence;
+}
+
+void CardProfileManagerAdapter::pauseIfNeeded(
+    std::shared_ptr<CardResource> cardResource,
+    const uint64_t sequence,
+    const std::chrono::steady_clock::time_point maxTime)
 {
     if (cardResource == nullptr && mGlobalConfiguration->isBlockingAllocationMode()) {
-        try {
-            Thread::sleep(mGlobalConfiguration->getCycleDurationMillis());
-        } catch (const InterruptedException& e) {
-            mLogger->error("Unexpected sleep interruption", e);
-            // FIXME: Thread::currentThread().interrupt();
-        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCardResourceAvailable.wait_until(lock, getWakeUpTime(maxTime), [&] {
+            return mAvailabilitySequence != sequence;
+        });
     }
 }
 
+std::chrono::steady_clock::time_point CardProfileManagerAdapter::getWakeUpTime(
+    const std::chrono::steady_clock::time_point maxTime) const
+{
+    /*
+     * Pool plugins may make a card resource available without any notification, in which case the
+     * availability is checked at least once per cycle. Expired usage timeouts are notified by the
+     * usage timeout reaper.
+     */
+    if (!mPoolPlugins.empty()) {
+        return std::min(maxTime,
+                        std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(
+                                mGlobalConfiguration->getCycleDurationMillis()));
+    }
+
+    return maxTime;
+}
+
 std::shared_ptr<CardResource> CardProfileManagerAdapter::getRegularOrPoolCardResource()
 {
     std::shared_ptr<CardResource> cardResource = nullptr;
@@ -204,10 +718,10 @@ std::shared_ptr<CardResource> CardProfileManagerAdapter::getRegularOrPoolCardRes
     if (mGlobalConfiguration->isUsePoolFirst()) {
         cardResource = getPoolCardResource();
         if (cardResource == nullptr) {
-            cardResource = getRegularCardResource();
+            cardResource = (this->*mGetRegularCardResource)();
         }
     } else {
-        cardResource = getRegularCardResource();
+        cardResource = (this->*mGetRegularCardResource)();
         if (cardResource == nullptr) {
             cardResource = getPoolCardResource();
         }
@@ -216,36 +730,108 @@ std::shared_ptr<CardResource> CardProfileManagerAdapter::getRegularOrPoolCardRes
     return cardResource;
 }
 
+template <typename Policy>
 std::shared_ptr<CardResource> CardProfileManagerAdapter::getRegularCardResource()
 {
     std::shared_ptr<CardResource> result = nullptr;
     std::vector<std::shared_ptr<CardResource>> unusableCardResources;
 
-    for (const std::shared_ptr<CardResource>& cardResource : mCardResources) {
-        std::shared_ptr<CardReader> reader = cardResource->getReader();
-        //FIXME synchronized (reader) {
-            std::shared_ptr<ReaderManagerAdapter> readerManager =
-                mService->getReaderManager(reader);
-            if (readerManager != nullptr) {
-                try {
-                    if (readerManager->lock(cardResource,
-                                            mCardProfile->getCardResourceProfileExtension())) {
-                        int cardResourceIndex = Arrays::indexOf(mCardResources, cardResource);
-                        updateCardResourcesOrder(cardResourceIndex);
-                        result = cardResource;
-                        break;
-                    }
-                } catch (const IllegalStateException& e) {
-                    (void)e;
-                    unusableCardResources.push_back(cardResource);
-                }
-            } else {
-                unusableCardResources.push_back(cardResource);
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (result == nullptr && !mFreeCardResources.empty()) {
+        const auto it = Policy::select(*this);
+        const uint64_t rank = it->first;
+        const std::shared_ptr<CardResource> cardResource = it->second;
+
+        /*
+         * Locked or found busy, the card resource is no longer free. Removing it before trying
+         * the reader lets concurrent threads try other card resources meanwhile.
+         */
+        removeFreeCardResource(rank);
+
+        lock.unlock();
+        const bool isLocked = lockCardResource(cardResource, unusableCardResources);
+        lock.lock();
+
+        if (isLocked) {
+            mCyclicCursor = rank;
+            result = cardResource;
+        }
+    }
+
+    lock.unlock();
+
+    /* Remove unusable card resources identified (outside the lock, the service calls back) */
+    for (const auto& cardResource : unusableCardResources) {
+        mService->removeCardResource(cardResource);
+    }
+
+    return result;
+}
+
+std::shared_ptr<CardResource> CardProfileManagerAdapter::getCustomCardResource()
+{
+    /* The candidates, in the configured order */
+    std::vector<uint64_t> ranks;
+    std::vector<std::shared_ptr<CardResource>> cardResources;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        ranks.reserve(mFreeCardResources.size());
+        cardResources.reserve(mFreeCardResources.size());
+        for (const auto& entry : mFreeCardResources) {
+            ranks.push_back(entry.first);
+            cardResources.push_back(entry.second);
+        }
+    }
+
+    std::shared_ptr<CardResource> result = nullptr;
+    std::vector<std::shared_ptr<CardResource>> unusableCardResources;
+
+    while (result == nullptr && !cardResources.empty()) {
+        /* The application code is invoked outside the lock */
+        std::size_t index;
+        try {
+            index = mGlobalConfiguration->getAllocationStrategySpi()->select(
+                mCardProfile->getProfileName(), cardResources);
+        } catch (const std::exception& e) {
+            mLogger->error("Allocation strategy failed for card resource profile '%': %\n",
+                           mCardProfile->getProfileName(),
+                           e.what());
+            break;
+        }
+
+        if (index >= cardResources.size()) {
+            mLogger->error("Invalid card resource index % selected by the allocation strategy " \
+                           "for card resource profile '%'\n",
+                           index,
+                           mCardProfile->getProfileName());
+            break;
+        }
+
+        const uint64_t rank = ranks[index];
+        const std::shared_ptr<CardResource> cardResource = cardResources[index];
+        ranks.erase(ranks.begin() + index);
+        cardResources.erase(cardResources.begin() + index);
+
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+
+            /* Allocated or removed meanwhile */
+            const auto it = mFreeCardResources.find(rank);
+            if (it == mFreeCardResources.end() || it->second != cardResource) {
+                continue;
             }
-        //}
+
+            removeFreeCardResource(rank);
+        }
+
+        if (lockCardResource(cardResource, unusableCardResources)) {
+            result = cardResource;
+        }
     }
 
-    /* Remove unusable card resources identified */
+    /* Remove unusable card resources identified (outside the lock, the service calls back) */
     for (const auto& cardResource : unusableCardResources) {
         mService->removeCardResource(cardResource);
     }
@@ -253,30 +839,150 @@ std::shared_ptr<CardResource> CardProfileManagerAdapter::getRegularCardResource(
     return result;
 }
 
-void CardProfileManagerAdapter::updateCardResourcesOrder(const int cardResourceIndex)
+bool CardProfileManagerAdapter::lockCardResource(
+    const std::shared_ptr<CardResource>& cardResource,
+    std::vector<std::shared_ptr<CardResource>>& unusableCardResources)
+{
+    /* The reader lock is atomic, concurrent callers can safely try the same reader */
+    std::shared_ptr<ReaderManagerAdapter> readerManager =
+        mService->getReaderManager(cardResource->getReader());
+    if (readerManager != nullptr) {
+        try {
+            if (readerManager->lock(cardResource,
+                                    mCardProfile->getCardResourceProfileExtension())) {
+                mService->onReaderLocked(readerManager, cardResource);
+                return true;
+            }
+        } catch (const IllegalStateException& e) {
+            (void)e;
+            unusableCardResources.push_back(cardResource);
+        }
+    } else {
+        unusableCardResources.push_back(cardResource);
+    }
+
+    return false;
+}
+
+uint64_t CardProfileManagerAdapter::getPriority(
+    const std::shared_ptr<ReaderManagerAdapter>& readerManager) const
+{
+    switch (mGlobalConfiguration->getAllocationStrategy()) {
+    case AllocationStrategy::LEAST_RECENTLY_USED:
+        return readerManager->getLastUnlockTimeMillis();
+    case AllocationStrategy::LEAST_LOADED:
+        return readerManager->getCumulativeBusyTimeMillis();
+    default:
+        return 0;
+    }
+}
+
+bool CardProfileManagerAdapter::addFreeCardResource(
+    const uint64_t rank, const std::shared_ptr<CardResource>& cardResource, const uint64_t priority)
+{
+    const auto result = mFreeCardResources.insert({rank, cardResource});
+    if (result.second) {
+        mFreeCardResourcePositions.insert({rank, mFreeCardResourceHeap.size()});
+        mFreeCardResourceHeap.push_back({priority, result.first});
+        siftUpFreeCardResource(mFreeCardResourceHeap.size() - 1);
+    }
+
+    return result.second;
+}
+
+void CardProfileManagerAdapter::removeFreeCardResource(const uint64_t rank)
 {
-    if (mGlobalConfiguration->getAllocationStrategy() == AllocationStrategy::CYCLIC) {
-        std::rotate(mCardResources.begin(),
-                    mCardResources.begin() - cardResourceIndex - 1,
-                    mCardResources.end());
-    } else if (mGlobalConfiguration->getAllocationStrategy() == AllocationStrategy::RANDOM) {
-        auto rng = std::default_random_engine {};
-        std::shuffle(std::begin(mCardResources), std::end(mCardResources), rng);
+    const auto it = mFreeCardResourcePositions.find(rank);
+    if (it == mFreeCardResourcePositions.end()) {
+        return;
     }
+
+    /* Replace by the last one, then restore the heap order from this position */
+    const std::size_t position = it->second;
+    const auto freeIt = mFreeCardResourceHeap[position].mIterator;
+    mFreeCardResourceHeap[position] = mFreeCardResourceHeap.back();
+    mFreeCardResourcePositions[mFreeCardResourceHeap[position].mIterator->first] = position;
+    mFreeCardResourceHeap.pop_back();
+    mFreeCardResourcePositions.erase(rank);
+    mFreeCardResources.erase(freeIt);
+
+    if (position < mFreeCardResourceHeap.size()) {
+        siftDownFreeCardResource(siftUpFreeCardResource(position));
+    }
+}
+
+bool CardProfileManagerAdapter::isBefore(const FreeCardResource& entry1,
+                                         const FreeCardResource& entry2)
+{
+    /* Ties are broken by rank to keep the configured order */
+    return entry1.mPriority < entry2.mPriority ||
+           (entry1.mPriority == entry2.mPriority &&
+            entry1.mIterator->first < entry2.mIterator->first);
+}
+
+std::size_t CardProfileManagerAdapter::siftUpFreeCardResource(std::size_t position)
+{
+    while (position > 0) {
+        const std::size_t parent = (position - 1) / 2;
+        if (!isBefore(mFreeCardResourceHeap[position], mFreeCardResourceHeap[parent])) {
+            break;
+        }
+
+        swapFreeCardResources(position, parent);
+        position = parent;
+    }
+
+    return position;
+}
+
+void CardProfileManagerAdapter::siftDownFreeCardResource(std::size_t position)
+{
+    const std::size_t size = mFreeCardResourceHeap.size();
+
+    while (true) {
+        std::size_t first = position;
+        const std::size_t left = 2 * position + 1;
+        const std::size_t right = left + 1;
+
+        if (left < size && isBefore(mFreeCardResourceHeap[left], mFreeCardResourceHeap[first])) {
+            first = left;
+        }
+
+        if (right < size && isBefore(mFreeCardResourceHeap[right], mFreeCardResourceHeap[first])) {
+            first = right;
+        }
+
+        if (first == position) {
+            return;
+        }
+
+        swapFreeCardResources(position, first);
+        position = first;
+    }
+}
+
+void CardProfileManagerAdapter::swapFreeCardResources(const std::size_t position1,
+                                                      const std::size_t position2)
+{
+    std::swap(mFreeCardResourceHeap[position1], mFreeCardResourceHeap[position2]);
+    mFreeCardResourcePositions[mFreeCardResourceHeap[position1].mIterator->first] = position1;
+    mFreeCardResourcePositions[mFreeCardResourceHeap[position2].mIterator->first] = position2;
 }
 
 std::shared_ptr<CardResource> CardProfileManagerAdapter::getPoolCardResource()
 {
     for (const std::shared_ptr<PoolPlugin>& poolPlugin : mPoolPlugins) {
         try {
+            const std::chrono::steady_clock::time_point allocationStartTime =
+                std::chrono::steady_clock::now();
             std::shared_ptr<CardReader> reader =
                 poolPlugin->allocateReader(mCardProfile->getReaderGroupReference());
+            mPoolAllocationTimeHistogram.record(std::chrono::steady_clock::now() -
+                                                allocationStartTime);
             if (reader != nullptr) {
                 std::shared_ptr<SmartCard> smartCard =
                     mCardProfile->getCardResourceProfileExtension()
-                                ->matches(reader,
-                                          SmartCardServiceProvider::getService()
-                                              ->createCardSelectionManager());
+                                ->matches(reader, getPoolCardSelectionManager(reader));
                 if (smartCard != nullptr) {
                     auto cardResource = std::make_shared<CardResource>(reader, smartCard);
                     mService->registerPoolCardResource(cardResource, poolPlugin);
@@ -292,6 +998,24 @@ std::shared_ptr<CardResource> CardProfileManagerAdapter::getPoolCardResource()
     return nullptr;
 }
 
+std::shared_ptr<CardSelectionManager> CardProfileManagerAdapter::getPoolCardSelectionManager(
+    const std::shared_ptr<CardReader>& reader)
+{
+    if (!mCardProfile->getCardResourceProfileExtension()->isCardSelectionManagerReusable()) {
+        return SmartCardServiceProvider::getService()->createCardSelectionManager();
+    }
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+
+    std::shared_ptr<CardSelectionManager>& cardSelectionManager =
+        mPoolCardSelectionManagers[reader->getName()];
+    if (cardSelectionManager == nullptr) {
+        cardSelectionManager = SmartCardServiceProvider::getService()->createCardSelectionManager();
+    }
+
+    return cardSelectionManager;
+}
+
 }
 }
 }
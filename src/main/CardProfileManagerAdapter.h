@@ -12,7 +12,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 /* Keyple Core Util */
@@ -24,7 +33,9 @@
 #include "CardResourceProfileConfigurator.h"
 #include "CardResourceServiceAdapter.h"
 #include "CardResourceServiceConfiguratorAdapter.h"
+#include "CardResourceServiceMetrics.h"
 #include "KeypleServiceResourceExport.h"
+#include "LatencyHistogram.h"
 
 /* Keyple Core Service */
 #include "Plugin.h"
@@ -46,12 +57,15 @@ using namespace keyple::core::util::cpp;
  *
  * @since 2.0.0
  */
-class KEYPLESERVICERESOURCE_API CardProfileManagerAdapter final {
+class KEYPLESERVICERESOURCE_API CardProfileManagerAdapter final
+: public std::enable_shared_from_this<CardProfileManagerAdapter> {
 public:
     /**
      * (package-private)<br>
-     * Creates a new card profile manager using the provided card profile and initializes all
-     * available card resources.
+     * Creates a new card profile manager using the provided card profile.
+     *
+     * <p>The card resources available at start are then probed by the service (see
+     * getAcceptedReaderManagers(), probeReader() and addCardResource()).
      *
      * @param cardProfile The associated card profile.
      * @param globalConfiguration The global configuration of the service.
@@ -61,6 +75,24 @@ public:
         std::shared_ptr<CardResourceProfileConfigurator> cardProfile,
         std::shared_ptr<CardResourceServiceConfiguratorAdapter> globalConfiguration);
 
+    /**
+     * (package-private)<br>
+     * Stops the manager if not already done, see stop().
+     *
+     * @since 2.1.0
+     */
+    ~CardProfileManagerAdapter();
+
+    /**
+     * (package-private)<br>
+     * Completes the pending asynchronous requests with null and stops the associated thread, the
+     * next asynchronous requests being completed at once with null.<br>
+     * Invoked when the card profile is removed from the service.
+     *
+     * @since 2.1.0
+     */
+    void stop();
+
     /**
      * (package-private)<br>
      * Removes the provided card resource from the profile manager if it is present.
@@ -72,35 +104,154 @@ public:
 
     /**
      * (package-private)<br>
-     * Invoked when a new reader is connected.<br>
-     * If the associated plugin is referenced on the card profile, then tries to initialize a card
-     * resource if the reader is accepted.
+     * Checks if the provided reader is used by the profile, that is if it belongs to one of the
+     * "regular" plugins of the profile and if it is accepted by the filter on the name.
      *
-     * @param readerManager The reader manager to use.
-     * @since 2.0.0
+     * @param readerManager The reader manager of the reader to check.
+     * @return True if it is accepted.
+     * @since 2.1.0
      */
-    void onReaderConnected(std::shared_ptr<ReaderManagerAdapter> readerManager);
+    bool isReaderAccepted(const std::shared_ptr<ReaderManagerAdapter>& readerManager) const;
 
     /**
      * (package-private)<br>
-     * Invoked when a new card is inserted.<br>
-     * The behaviour is the same as if a reader was connected.
+     * Invoked when a reader is unlocked.<br>
+     * Makes the card resources of the reader belonging to the profile free again and wakes up the
+     * waiting threads, only if there are some.
+     *
+     * @param readerManager The reader manager of the unlocked reader.
+     * @since 2.1.0
+     */
+    void onReaderUnlocked(std::shared_ptr<ReaderManagerAdapter> readerManager);
+
+    /**
+     * (package-private)<br>
+     * Wakes up the threads waiting for a card resource in blocking allocation mode.<br>
+     * Invoked when a card resource may have become available (release, card insertion, reader
+     * connection).
      *
-     * @param readerManager The reader manager to use.
      * @since 2.0.0
      */
-    void onCardInserted(std::shared_ptr<ReaderManagerAdapter> readerManager);
+    void notifyCardResourceAvailable();
 
     /**
      * (package-private)<br>
      * Tries to get a card resource and locks the associated reader.<br>
-     * Applies the configured allocation strategy by looping, pausing, ordering resources.
+     * Applies the configured allocation strategy by looping, waiting, ordering resources.
      *
      * @return Null if there is no card resource available.
      * @since 2.0.0
      */
     std::shared_ptr<CardResource> getCardResource();
 
+    /**
+     * (package-private)<br>
+     * Tries to get a card resource asynchronously.
+     *
+     * <p>If the blocking allocation mode is enabled and no card resource is immediately available,
+     * then the request is queued with the waiting threads and completed when a card resource is
+     * handed over to it or when the timeout expires.
+     *
+     * @param callback The function to invoke with the card resource, or null if there is no card
+     *        resource available.
+     * @since 2.1.0
+     */
+    void getCardResource(std::function<void(std::shared_ptr<CardResource>)> callback);
+
+    /**
+     * (package-private)<br>
+     * Makes a single attempt to get a card resource searching in "regular" and/or "pool" plugins.
+     *
+     * @return Null if there is no card resource available.
+     * @since 2.0.0
+     */
+    std::shared_ptr<CardResource> tryGetCardResource();
+
+    /**
+     * (package-private)<br>
+     * Waits until at least the provided number of card resources are free or the provided deadline
+     * is reached.
+     *
+     * <p>When pool plugins are configured, the availability may change without notification, so
+     * the wait does not exceed a cycle.
+     *
+     * @param count The number of card resources needed.
+     * @param maxTime The deadline.
+     * @since 2.1.0
+     */
+    void waitForCardResources(const std::size_t count,
+                              const std::chrono::steady_clock::time_point maxTime);
+
+    /**
+     * (package-private)<br>
+     * Gets the managers of the readers of the "regular" plugins accepted by the profile.
+     *
+     * @return A not null collection, in the configured order of the plugins and readers.
+     * @since 2.1.0
+     */
+    std::vector<std::shared_ptr<ReaderManagerAdapter>> getAcceptedReaderManagers() const;
+
+    /**
+     * (package-private)<br>
+     * Activates the provided reader manager if it is not already activated and checks if the
+     * inserted card matches the profile.
+     *
+     * <p>The provided reader must be accepted by the profile. Different readers may be probed
+     * concurrently.
+     *
+     * @param readerManager The reader manager to use.
+     * @return Null if the inserted card does not match the profile.
+     * @since 2.1.0
+     */
+    std::shared_ptr<CardResource> probeReader(std::shared_ptr<ReaderManagerAdapter> readerManager);
+
+    /**
+     * (package-private)<br>
+     * Adds the provided card resource matched by the profile, or makes it free again if it is
+     * already present, and wakes up the waiting threads.
+     *
+     * @param readerManager The reader manager of the card resource.
+     * @param cardResource The card resource to add.
+     * @since 2.1.0
+     */
+    void addCardResource(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                         std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * (package-private)<br>
+     * Same as addCardResource(readerManager, cardResource), but places a new card resource at the
+     * provided rank, so that the card resources can be added in any order while keeping the
+     * configured order of the readers.
+     *
+     * @param readerManager The reader manager of the card resource.
+     * @param cardResource The card resource to add.
+     * @param rank The rank of the card resource, 0 to place it after all the existing ones.
+     * @since 2.1.0
+     */
+    void addCardResource(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                         std::shared_ptr<CardResource> cardResource,
+                         const uint64_t rank);
+
+    /**
+     * (package-private)<br>
+     * Records the outcome and the duration of a request of a card resource of the profile.
+     *
+     * @param requestTime The time of the request.
+     * @param cardResource The card resource allocated, null if the request failed.
+     * @since 2.1.0
+     */
+    void recordAllocation(const std::chrono::steady_clock::time_point requestTime,
+                          const std::shared_ptr<CardResource>& cardResource);
+
+    /**
+     * (package-private)<br>
+     * Gets a snapshot of the metrics of the profile.
+     *
+     * @return A new instance.
+     * @since 2.1.0
+     */
+    CardResourceServiceMetrics::ProfileMetrics getMetrics();
+
 private:
     /**
      *
@@ -134,9 +285,57 @@ private:
     std::vector<std::shared_ptr<PoolPlugin>> mPoolPlugins;
 
     /**
-     * The current available card resources associated with "regular" plugins
+     * The rank of each current available card resource associated with "regular" plugins (i.e. the
+     * configured order of the readers at start, then the order of their addition)
+     */
+    std::unordered_map<std::shared_ptr<CardResource>, uint64_t> mCardResourceRanks;
+
+    /**
+     * The card resources not known to be busy, by rank.<br>
+     * A card resource leaves this index when it is locked or found busy and comes back when its
+     * reader is unlocked. Both cost O(log n) (ordered map and heap below), the selection itself
+     * being O(1), or O(log n) for the cyclic strategy.
+     */
+    std::map<uint64_t, std::shared_ptr<CardResource>> mFreeCardResources;
+
+    /**
+     * (private)<br>
+     * An entry of the free card resources heap.
+     */
+    struct FreeCardResource {
+        /**
+         * The priority of the entry, the lowest first (last unlock time or cumulative busy time of
+         * the reader when the card resource became free, 0 if not relevant for the strategy)
+         */
+        uint64_t mPriority;
+
+        /**
+         * The entry of the free card resources index
+         */
+        std::map<uint64_t, std::shared_ptr<CardResource>>::iterator mIterator;
+    };
+
+    /**
+     * Random access view of the free card resources index, organized as an indexed binary min-heap
+     * on the priority
+     */
+    std::vector<FreeCardResource> mFreeCardResourceHeap;
+
+    /**
+     * The position of each free card resource rank in the heap
+     */
+    std::unordered_map<uint64_t, std::size_t> mFreeCardResourcePositions;
+
+    /**
+     * The rank to assign to the next added card resource
+     */
+    uint64_t mNextRank;
+
+    /**
+     * Ring cursor of the cyclic strategy: the rank of the last allocated card resource.<br>
+     * The next search starts right after it and wraps around to the lowest rank.
      */
-    std::vector<std::shared_ptr<CardResource>> mCardResources;
+    std::atomic<uint64_t> mCyclicCursor;
 
     /**
      * The filter on the reader name if set
@@ -145,54 +344,212 @@ private:
 
     /**
      * (private)<br>
-     * Initializes card resources using the plugins configured on the card profile.
+     * A thread waiting for a card resource in fair allocation mode, or an asynchronous request.
+     */
+    struct Waiter {
+        /**
+         * The card resource handed over to the waiter, null while waiting
+         */
+        std::shared_ptr<CardResource> mCardResource;
+
+        /**
+         * Signaled when a card resource is handed over
+         */
+        std::condition_variable mCondition;
+
+        /**
+         * The completion function of an asynchronous request, empty for a waiting thread
+         */
+        std::function<void(std::shared_ptr<CardResource>)> mCallback;
+
+        /**
+         * The deadline of an asynchronous request
+         */
+        std::chrono::steady_clock::time_point mMaxTime;
+    };
+
+    /**
+     * Protects the card resources indexes, the availability sequence, the waiters queue and the
+     * pool card selection managers
+     */
+    std::mutex mMutex;
+
+    /**
+     * Signaled each time a card resource may have become available
+     */
+    std::condition_variable mCardResourceAvailable;
+
+    /**
+     * Incremented on each availability notification, used to detect the notifications occurring
+     * between an unsuccessful allocation attempt and the wait
+     */
+    uint64_t mAvailabilitySequence;
+
+    /**
+     * The threads waiting for a card resource in fair allocation mode and the pending asynchronous
+     * requests, oldest first
+     */
+    std::deque<std::shared_ptr<Waiter>> mWaiters;
+
+    /**
+     * The card selection managers already provided to the profile extension, by name of reader
+     * allocated from a "pool" plugin, if the extension allows their reuse
+     */
+    std::unordered_map<std::string, std::shared_ptr<CardSelectionManager>>
+        mPoolCardSelectionManagers;
+
+    /**
+     * Signaled when an asynchronous request is queued or when the manager is destroyed
+     */
+    std::condition_variable mAsyncWaitersChanged;
+
+    /**
+     * Expires the pending asynchronous requests, running only while there are some
+     */
+    std::thread mAsyncWaitersMonitor;
+
+    /**
+     *
+     */
+    bool mIsAsyncWaitersMonitorRunning;
+
+    /**
+     * The number of card resources allocated
+     */
+    std::atomic<uint64_t> mAllocationCount;
+
+    /**
+     * The number of requests ended without card resource in non-blocking mode
+     */
+    std::atomic<uint64_t> mAllocationFailureCount;
+
+    /**
+     * The number of requests ended without card resource in blocking mode
+     */
+    std::atomic<uint64_t> mAllocationTimeoutCount;
+
+    /**
+     * The durations of the requests
+     */
+    LatencyHistogram mAcquireWaitTimeHistogram;
+
+    /**
+     * The durations of the reader allocations of the "pool" plugins
+     */
+    LatencyHistogram mPoolAllocationTimeHistogram;
+
+    /**
+     * Set by stop()
+     */
+    bool mIsStopping;
+
+    /**
+     * (private)<br>
+     * Initializes the "regular" and "pool" plugins using the plugins configured on the card
+     * profile.
+     */
+    void initializePluginsUsingProfilePlugins();
+
+    /**
+     * (private)<br>
+     * Initializes the "regular" and "pool" plugins using the plugins configured on the card
+     * resource service.
      */
-    void initializeCardResourcesUsingProfilePlugins();
+    void initializePluginsUsingDefaultPlugins();
 
     /**
      * (private)<br>
-     * Initializes card resources using the plugins configured on the card resource service.
+     * Checks if the provided reader is accepted using the filter on the name.
+     *
+     * @param reader The reader to check.
+     * @return True if it is accepted.
      */
-    void initializeCardResourcesUsingDefaultPlugins();
+    bool isReaderAccepted(std::shared_ptr<CardReader> reader) const;
 
     /**
      * (private)<br>
-     * Initializes all available card resources by analysing all readers of the provided "regular"
-     * plugin.
+     * Gets a card resource in fair blocking allocation mode.<br>
+     * The calling thread is queued behind the older waiters and waits for a card resource to be
+     * handed over to it.
      *
-     * @param plugin The "regular" plugin to analyse.
+     * @return Null if there is no card resource available before the timeout.
      */
-    void initializeCardResources(std::shared_ptr<Plugin> plugin);
+    std::shared_ptr<CardResource> getCardResourceFairly();
 
     /**
      * (private)<br>
-     * Tries to initialize a card resource for the provided reader manager only if the reader is
-     * accepted by the profile.
+     * Gets a card resource in non-blocking or non-fair blocking allocation mode.<br>
+     * In blocking mode, the calling thread retries each time a card resource may have become
+     * available, until the timeout.
      *
-     * <p>If the reader is accepted, then activates the provided reader manager if it is not already
-     * activated.
+     * @return Null if there is no card resource available.
+     */
+    std::shared_ptr<CardResource> getCardResourceUnfairly();
+
+    /**
+     * (private)<br>
+     * Hands over the available card resources to the oldest waiters, as long as there are waiters
+     * and available card resources.
+     */
+    void serveWaiters();
+
+    /**
+     * (private)<br>
+     * Body of the thread completing with null the expired asynchronous requests.<br>
+     * When a usage timeout or pool plugins are configured, also hands over the card resources
+     * which have become available without notification, once per cycle.<br>
+     * Terminates when there are no more pending asynchronous requests.
      *
-     * @param readerManager The reader manager to use.
+     * <p>The thread keeps the manager alive until it terminates, the manager being possibly
+     * stopped and released by a callback it completes.
      */
-    void initializeCardResource(std::shared_ptr<ReaderManagerAdapter> readerManager);
+    void monitorAsyncWaiters();
 
     /**
      * (private)<br>
-     * Checks if the provided reader is accepted using the filter on the name.
+     * Invokes the provided completion function of an asynchronous request, logging the exceptions
+     * it may raise.
      *
-     * @param reader The reader to check.
-     * @return True if it is accepted.
+     * <p>If the completion function fails, whatever it throws, then the provided card resource is
+     * released.
+     *
+     * @param callback The function to invoke.
+     * @param cardResource The card resource to provide, null if none.
+     */
+    void complete(const std::function<void(std::shared_ptr<CardResource>)>& callback,
+                  std::shared_ptr<CardResource> cardResource);
+
+    /**
+     * (private)<br>
+     * Gets the current availability sequence number.
+     *
+     * @return The value to provide to pauseIfNeeded.
      */
-    bool isReaderAccepted(std::shared_ptr<CardReader> reader);
+    uint64_t getAvailabilitySequence();
 
     /**
      * (private)<br>
-     * Make a pause if the provided card resource is null and a blocking allocation mode is
-     * requested.
+     * Waits for an availability notification if the provided card resource is null and a blocking
+     * allocation mode is requested.
      *
      * @param cardResource The founded card resource or null if not found.
+     * @param sequence The availability sequence number read before the allocation attempt.
+     * @param maxTime The allocation deadline.
      */
-    void pauseIfNeeded(std::shared_ptr<CardResource> cardResource);
+    void pauseIfNeeded(std::shared_ptr<CardResource> cardResource,
+                       const uint64_t sequence,
+                       const std::chrono::steady_clock::time_point maxTime);
+
+    /**
+     * (private)<br>
+     * Computes the time until which a waiting thread can sleep without checking the availability.
+     *
+     * @param maxTime The allocation deadline.
+     * @return The max time if all availability changes are notified, the end of the current cycle
+     *         otherwise.
+     */
+    std::chrono::steady_clock::time_point getWakeUpTime(
+        const std::chrono::steady_clock::time_point maxTime) const;
 
     /**
      * (private)<br>
@@ -206,20 +563,130 @@ private:
      * (private)<br>
      * Tries to get a card resource searching in all "regular" plugins.
      *
+     * <p>Only the free card resources are tried, each attempt costing O(log n). A card resource
+     * whose usage timeout expires is made free again by the usage timeout reaper.
+     *
      * <p>If a card resource is no more usable, then removes it from the service.
      *
      * @return Null if there is no card resource available.
      */
+    template <typename Policy>
     std::shared_ptr<CardResource> getRegularCardResource();
 
     /**
      * (private)<br>
-     * Updates the order of the created card resources according to the configured strategy.
+     * Tries to get a card resource searching in all "regular" plugins, the card resource to try
+     * being chosen by the custom allocation strategy.
      *
-     * @param cardResourceIndex The current card resource index of the available card resource
-     *     founded.
+     * <p>The free card resources are taken once, the allocation strategy being then invoked
+     * outside the lock with the candidates not tried yet. A candidate allocated or removed
+     * meanwhile is skipped.
+     *
+     * <p>A failure of the allocation strategy or an invalid index is logged, no card resource
+     * being then allocated.
+     *
+     * @return Null if there is no card resource available.
+     */
+    std::shared_ptr<CardResource> getCustomCardResource();
+
+    /**
+     * (private)<br>
+     * Tries to lock the reader of the provided card resource.
+     *
+     * @param cardResource The card resource to lock.
+     * @param unusableCardResources The collection where to add the card resource if it is no more
+     *        usable.
+     * @return True if the card resource is locked.
+     */
+    bool lockCardResource(const std::shared_ptr<CardResource>& cardResource,
+                          std::vector<std::shared_ptr<CardResource>>& unusableCardResources);
+
+    /**
+     * (private)<br>
+     * Selection policies of the allocation strategies.
+     *
+     * <p>Each policy provides a static <code>select(CardProfileManagerAdapter&)</code> function
+     * returning a valid iterator on the non empty free card resources index. Policies are bound
+     * once at construction through the template getRegularCardResource(), so that the selection
+     * is inlined without any runtime dispatch on the configured strategy.
+     */
+    struct FirstPolicy;
+    struct CyclicPolicy;
+    struct RandomPolicy;
+    struct PriorityPolicy;
+
+    /**
+     * (private)<br>
+     * Instance of getRegularCardResource(), or getCustomCardResource(), matching the configured
+     * allocation strategy.
+     */
+    std::shared_ptr<CardResource> (CardProfileManagerAdapter::*mGetRegularCardResource)();
+
+    /**
+     * (private)<br>
+     * Gets the current priority of the provided reader according to the configured strategy.
+     *
+     * @param readerManager The reader manager.
+     * @return 0 if the strategy does not use priorities.
+     */
+    uint64_t getPriority(const std::shared_ptr<ReaderManagerAdapter>& readerManager) const;
+
+    /**
+     * (private)<br>
+     * Adds a card resource to the free card resources index if it is not already present.
+     *
+     * @param rank The rank of the card resource.
+     * @param cardResource The card resource.
+     * @param priority The priority of the card resource.
+     * @return True if the card resource has been added.
+     */
+    bool addFreeCardResource(const uint64_t rank,
+                             const std::shared_ptr<CardResource>& cardResource,
+                             const uint64_t priority);
+
+    /**
+     * (private)<br>
+     * Removes a card resource from the free card resources index if it is present.
+     *
+     * @param rank The rank of the card resource.
+     */
+    void removeFreeCardResource(const uint64_t rank);
+
+    /**
+     * (private)<br>
+     * Indicates if the first entry must be closer to the top of the heap than the second one.
+     *
+     * @param entry1 The first entry.
+     * @param entry2 The second entry.
+     * @return True if the first entry has a lower priority, or the same priority and a lower rank.
      */
-    void updateCardResourcesOrder(const int cardResourceIndex);
+    static bool isBefore(const FreeCardResource& entry1, const FreeCardResource& entry2);
+
+    /**
+     * (private)<br>
+     * Moves up the heap entry at the provided position until the heap order is restored.
+     *
+     * @param position The position of the entry.
+     * @return The new position of the entry.
+     */
+    std::size_t siftUpFreeCardResource(std::size_t position);
+
+    /**
+     * (private)<br>
+     * Moves down the heap entry at the provided position until the heap order is restored.
+     *
+     * @param position The position of the entry.
+     */
+    void siftDownFreeCardResource(std::size_t position);
+
+    /**
+     * (private)<br>
+     * Swaps two heap entries and updates their positions.
+     *
+     * @param position1 The position of the first entry.
+     * @param position2 The position of the second entry.
+     */
+    void swapFreeCardResources(const std::size_t position1, const std::size_t position2);
 
     /**
      * (private)<br>
@@ -228,6 +695,20 @@ private:
      * @return Null if there is no card resource available.
      */
     std::shared_ptr<CardResource> getPoolCardResource();
+
+    /**
+     * (private)<br>
+     * Gets the card selection manager to use with the profile extension for the provided reader
+     * allocated from a "pool" plugin.
+     *
+     * <p>If the extension allows it, then the same instance is returned for all calls with the
+     * same reader name, otherwise a new instance is created.
+     *
+     * @param reader The allocated reader.
+     * @return A not null reference.
+     */
+    std::shared_ptr<CardSelectionManager> getPoolCardSelectionManager(
+        const std::shared_ptr<CardReader>& reader);
 };
 
 }
@@ -23,7 +23,7 @@ namespace resource {
 using namespace keyple::core::util;
 
 CardResource::CardResource(std::shared_ptr<CardReader> reader, std::shared_ptr<SmartCard> smartCard)
-: mReader(reader), mSmartCard(smartCard)
+: mReader(reader), mSmartCard(smartCard), mFingerprint(computeFingerprint(smartCard))
 {
     Assert::getInstance().notNull(reader, "reader").notNull(smartCard, "smartCard");
 }
@@ -38,6 +38,37 @@ std::shared_ptr<SmartCard> CardResource::getSmartCard() const
     return mSmartCard;
 }
 
+uint64_t CardResource::getFingerprint() const
+{
+    return mFingerprint;
+}
+
+uint64_t CardResource::computeFingerprint(const std::shared_ptr<SmartCard> smartCard)
+{
+    if (smartCard == nullptr) {
+        return 0;
+    }
+
+    static const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    uint64_t fingerprint = FNV_OFFSET_BASIS;
+
+    const std::string& powerOnData = smartCard->getPowerOnData();
+    for (const char c : powerOnData) {
+        fingerprint = (fingerprint ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+    }
+
+    /* The length separates the power-on data from the select application response */
+    fingerprint = (fingerprint ^ powerOnData.size()) * FNV_PRIME;
+
+    for (const uint8_t b : smartCard->getSelectApplicationResponse()) {
+        fingerprint = (fingerprint ^ b) * FNV_PRIME;
+    }
+
+    return fingerprint;
+}
+
 }
 }
 }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 /* Calypsonet Terminal Reader */
@@ -61,6 +62,29 @@ public:
      */
     std::shared_ptr<SmartCard> getSmartCard() const;
 
+    /**
+     * (package-private)<br>
+     * Gets the fingerprint of the SmartCard computed at creation.
+     *
+     * @return The fingerprint of the power-on data and of the select application response.
+     * @since 2.1.0
+     */
+    uint64_t getFingerprint() const;
+
+    /**
+     * (package-private)<br>
+     * Computes a 64-bit fingerprint (FNV-1a) of the power-on data and of the select application
+     * response of the provided SmartCard.
+     *
+     * <p>Two SmartCards having different fingerprints are different, while two SmartCards having
+     * the same fingerprint must still be fully compared.
+     *
+     * @param smartCard The SmartCard.
+     * @return 0 if the provided SmartCard is null.
+     * @since 2.1.0
+     */
+    static uint64_t computeFingerprint(const std::shared_ptr<SmartCard> smartCard);
+
 private:
     /**
      * 
@@ -71,6 +95,11 @@ private:
      * 
      */
     std::shared_ptr<SmartCard> mSmartCard;
+
+    /**
+     *
+     */
+    const uint64_t mFingerprint;
 };
 
 }
@@ -0,0 +1,115 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#include "CardResourceLease.h"
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+
+/* Keyple Service Resource */
+#include "CardResourceServiceAdapter.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+using namespace keyple::core::util::cpp::exception;
+
+CardResourceLease::CardResourceLease() : mLockDeadlineMillis(0) {}
+
+CardResourceLease::CardResourceLease(std::shared_ptr<CardResourceServiceAdapter> service,
+                                     std::shared_ptr<CardResource> cardResource,
+                                     std::shared_ptr<ReaderManagerAdapter> readerManager,
+                                     const uint64_t lockDeadlineMillis)
+: mService(service),
+  mCardResource(cardResource),
+  mReaderManager(readerManager),
+  mLockDeadlineMillis(lockDeadlineMillis) {}
+
+CardResourceLease::CardResourceLease(CardResourceLease&& other) noexcept
+: mService(std::move(other.mService)),
+  mCardResource(std::move(other.mCardResource)),
+  mReaderManager(std::move(other.mReaderManager)),
+  mLockDeadlineMillis(other.mLockDeadlineMillis) {}
+
+CardResourceLease& CardResourceLease::operator=(CardResourceLease&& other) noexcept
+{
+    if (this != &other) {
+        release();
+
+        mService = std::move(other.mService);
+        mCardResource = std::move(other.mCardResource);
+        mReaderManager = std::move(other.mReaderManager);
+        mLockDeadlineMillis = other.mLockDeadlineMillis;
+    }
+
+    return *this;
+}
+
+CardResourceLease::~CardResourceLease()
+{
+    release();
+}
+
+std::shared_ptr<CardResource> CardResourceLease::getCardResource() const
+{
+    return mCardResource;
+}
+
+bool CardResourceLease::isHeld() const
+{
+    return mCardResource != nullptr;
+}
+
+void CardResourceLease::renew()
+{
+    checkHeld();
+
+    mLockDeadlineMillis =
+        mService->renewLeasedCardResource(mCardResource, mReaderManager, mLockDeadlineMillis);
+}
+
+void CardResourceLease::extend(const int durationMillis)
+{
+    checkHeld();
+
+    mLockDeadlineMillis = mService->extendLeasedCardResource(
+        mCardResource, mReaderManager, mLockDeadlineMillis, durationMillis);
+}
+
+void CardResourceLease::release()
+{
+    if (mCardResource == nullptr) {
+        return;
+    }
+
+    mService->releaseLeasedCardResource(mCardResource, mReaderManager, mLockDeadlineMillis);
+
+    mService = nullptr;
+    mCardResource = nullptr;
+    mReaderManager = nullptr;
+    mLockDeadlineMillis = 0;
+}
+
+void CardResourceLease::checkHeld() const
+{
+    if (mCardResource == nullptr) {
+        throw IllegalStateException("The card resource lease is empty or released.");
+    }
+}
+
+}
+}
+}
+}
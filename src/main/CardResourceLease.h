@@ -0,0 +1,192 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+#include "KeypleServiceResourceExport.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+using namespace keyple::core::service;
+
+class CardResourceServiceAdapter;
+class ReaderManagerAdapter;
+
+/**
+ * Scoped allocation of a {@link CardResource}, provided by {@link
+ * CardResourceService::acquireCardResource(const std::string&)}.
+ *
+ * <p>The card resource is released when the lease is destroyed or explicitly released, including
+ * on exception paths. A lease can be moved but not copied, the card resource being released only
+ * once.
+ *
+ * <p>The card resource of a lease must not be released, removed, renewed or extended using the
+ * {@link CardResourceService} methods. The lease owns the lock of the reader, which is released
+ * only if it has not expired meanwhile.
+ *
+ * @since 2.1.0
+ */
+class KEYPLESERVICERESOURCE_API CardResourceLease final {
+public:
+    /**
+     * Creates an empty lease, holding no card resource.
+     *
+     * @since 2.1.0
+     */
+    CardResourceLease();
+
+    /**
+     * Takes over the card resource of the provided lease, which becomes empty.
+     *
+     * @param other The lease to move.
+     * @since 2.1.0
+     */
+    CardResourceLease(CardResourceLease&& other) noexcept;
+
+    /**
+     * Releases the current card resource if any, then takes over the card resource of the provided
+     * lease, which becomes empty.
+     *
+     * @param other The lease to move.
+     * @return The current lease.
+     * @since 2.1.0
+     */
+    CardResourceLease& operator=(CardResourceLease&& other) noexcept;
+
+    /**
+     *
+     */
+    CardResourceLease(const CardResourceLease&) = delete;
+
+    /**
+     *
+     */
+    CardResourceLease& operator=(const CardResourceLease&) = delete;
+
+    /**
+     * Releases the card resource if any.
+     *
+     * @since 2.1.0
+     */
+    ~CardResourceLease();
+
+    /**
+     * Gets the leased card resource.
+     *
+     * @return Null if the lease is empty or released.
+     * @since 2.1.0
+     */
+    std::shared_ptr<CardResource> getCardResource() const;
+
+    /**
+     * Indicates if the lease holds a card resource.
+     *
+     * @return False if the lease is empty or released.
+     * @since 2.1.0
+     */
+    bool isHeld() const;
+
+    /**
+     * Renews the usage timeout of the card resource (see {@link
+     * CardResourceService::renewCardResource(std::shared_ptr<CardResource>)}).
+     *
+     * @throw IllegalStateException If the lease is empty or released, if the service is not
+     *        started or if the usage timeout already expired.
+     * @since 2.1.0
+     */
+    void renew();
+
+    /**
+     * Extends the usage timeout of the card resource by the provided duration (see {@link
+     * CardResourceService::extendCardResource(std::shared_ptr<CardResource>, const int)}).
+     *
+     * @param durationMillis The duration to add to the current usage timeout (in milliseconds).
+     * @throw IllegalArgumentException If the duration is less than 1.
+     * @throw IllegalStateException If the lease is empty or released, if the service is not
+     *        started or if the usage timeout already expired.
+     * @since 2.1.0
+     */
+    void extend(const int durationMillis);
+
+    /**
+     * Releases the card resource to make it available to other users, the lease becoming empty.
+     *
+     * <p>Nothing is done if the lease is already empty.
+     *
+     * @since 2.1.0
+     */
+    void release();
+
+private:
+    /**
+     * (private)<br>
+     * Only the service creates leases holding a card resource.
+     */
+    friend class CardResourceServiceAdapter;
+
+    /**
+     * The service which allocated the card resource
+     */
+    std::shared_ptr<CardResourceServiceAdapter> mService;
+
+    /**
+     * The leased card resource, null if the lease is empty
+     */
+    std::shared_ptr<CardResource> mCardResource;
+
+    /**
+     * The reader manager of the card resource, null if the card resource comes from a pool plugin
+     */
+    std::shared_ptr<ReaderManagerAdapter> mReaderManager;
+
+    /**
+     * The deadline of the lock of the reader owned by the lease, 0 if it has no usage timeout
+     */
+    uint64_t mLockDeadlineMillis;
+
+    /**
+     * (private)<br>
+     * Creates a lease holding an allocated card resource.
+     *
+     * @param service The service which allocated the card resource.
+     * @param cardResource The allocated card resource.
+     * @param readerManager The reader manager of the card resource, null for a pool plugin.
+     * @param lockDeadlineMillis The deadline of the lock of the reader, 0 if it has no usage
+     *        timeout.
+     */
+    CardResourceLease(std::shared_ptr<CardResourceServiceAdapter> service,
+                      std::shared_ptr<CardResource> cardResource,
+                      std::shared_ptr<ReaderManagerAdapter> readerManager,
+                      const uint64_t lockDeadlineMillis);
+
+    /**
+     * (private)<br>
+     * Checks that the lease holds a card resource.
+     *
+     * @throw IllegalStateException If the lease is empty or released.
+     */
+    void checkHeld() const;
+};
+
+}
+}
+}
+}
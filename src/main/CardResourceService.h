@@ -12,8 +12,16 @@
 
 #pragma once
 
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
 /* Keyple Service Resource */
 #include "CardResource.h"
+#include "CardResourceLease.h"
+#include "CardResourceServiceMetrics.h"
 #include "CardResourceServiceConfigurator.h"
 
 namespace keyple {
@@ -93,6 +101,111 @@ public:
     virtual std::shared_ptr<CardResource> getCardResource(
         const std::string& cardResourceProfileName) const = 0;
 
+    /**
+     * Gets asynchronously the first card resource available for the provided card resource profile
+     * name using the configured allocation strategy.
+     *
+     * <p>The provided callback is invoked exactly once with the allocated card resource, or with
+     * null if no card resource is available (in blocking allocation mode, if none becomes
+     * available before the configured timeout). No thread is held while the request is pending.
+     *
+     * <p>If a card resource is immediately available, or if the blocking allocation mode is not
+     * enabled, then the callback is invoked by the calling thread before this method returns.
+     * Otherwise, it is invoked by the thread releasing the handed over card resource, or by an
+     * internal thread of the service on timeout. The callback should therefore return quickly and
+     * must not stop the service.
+     *
+     * <p>An exception thrown by the callback is logged and not propagated, the card resource
+     * provided being then released.
+     *
+     * <p>Pending requests are completed with null when the service is stopped.
+     *
+     * @param cardResourceProfileName The name of the card resource profile.
+     * @param callback The function to invoke on completion.
+     * @throw IllegalArgumentException If the profile name is null, empty or not configured or if
+     *        the callback is null.
+     * @throw IllegalStateException If the service is not started.
+     * @since 2.1.0
+     */
+    virtual void getCardResourceAsync(
+        const std::string& cardResourceProfileName,
+        std::function<void(std::shared_ptr<CardResource>)> callback) const = 0;
+
+    /**
+     * Gets asynchronously the first card resource available for the provided card resource profile
+     * name using the configured allocation strategy.
+     *
+     * <p>Same as {@link #getCardResourceAsync(const std::string&, std::function)}, the returned
+     * future being ready when the request is completed.
+     *
+     * @param cardResourceProfileName The name of the card resource profile.
+     * @return A valid future holding null if no card resource is available.
+     * @throw IllegalArgumentException If the profile name is null, empty or not configured.
+     * @throw IllegalStateException If the service is not started.
+     * @since 2.1.0
+     */
+    virtual std::future<std::shared_ptr<CardResource>> getCardResourceAsync(
+        const std::string& cardResourceProfileName) const = 0;
+
+    /**
+     * Gets the requested number of card resources for the provided card resource profile name,
+     * all or nothing.
+     *
+     * <p>Same as {@link #getCardResources(const std::vector<std::string>&)} with the profile name
+     * repeated the requested number of times.
+     *
+     * @param cardResourceProfileName The name of the card resource profile.
+     * @param count The number of card resources requested.
+     * @return An empty list if the requested card resources are not all available.
+     * @throw IllegalArgumentException If the profile name is null, empty or not configured or if
+     *        the count is less than 1.
+     * @throw IllegalStateException If the service is not started.
+     * @since 2.1.0
+     */
+    virtual const std::vector<std::shared_ptr<CardResource>> getCardResources(
+        const std::string& cardResourceProfileName, const int count) = 0;
+
+    /**
+     * Gets one card resource for each of the provided card resource profile names, all or nothing.
+     *
+     * <p>The card resources are allocated in a single pass. If one of them is not available, then
+     * those already allocated are released, so that a partial allocation is never held while
+     * waiting and concurrent batch requests cannot deadlock each other. In blocking allocation mode,
+     * the request is retried when enough card resources of the missing profile have become free,
+     * until the configured timeout.
+     *
+     * <p>Batch requests do not queue behind the waiting requests of the fair allocation mode.
+     *
+     * <p><u>Note</u> : Each returned resource must then be released using the
+     * {@link #releaseCardResource(CardResource)} method.
+     *
+     * @param cardResourceProfileNames The names of the card resource profiles, possibly repeated.
+     * @return The card resources in the order of the provided profile names, or an empty list if
+     *         they are not all available.
+     * @throw IllegalArgumentException If the list is empty or if one of the profile names is empty
+     *        or not configured.
+     * @throw IllegalStateException If the service is not started.
+     * @since 2.1.0
+     */
+    virtual const std::vector<std::shared_ptr<CardResource>> getCardResources(
+        const std::vector<std::string>& cardResourceProfileNames) = 0;
+
+    /**
+     * Gets a card resource as for {@link #getCardResource(const std::string&)}, held by a lease
+     * which releases it when destroyed.
+     *
+     * <p>Releasing a card resource through its lease is cheaper than using {@link
+     * #releaseCardResource(std::shared_ptr<CardResource>)}, and the card resource can no longer be
+     * leaked when an exception is raised.
+     *
+     * @param cardResourceProfileName The name of the card resource profile.
+     * @return An empty lease if no card resource matching the profile is available.
+     * @throw IllegalArgumentException If the profile name is null, empty or not configured.
+     * @throw IllegalStateException If the service is not started.
+     * @since 2.1.0
+     */
+    virtual CardResourceLease acquireCardResource(const std::string& cardResourceProfileName) = 0;
+
     /**
      * Releases the card resource to make it available to other users.
      *
@@ -102,6 +215,41 @@ public:
      */
     virtual void releaseCardResource(std::shared_ptr<CardResource> cardResource) = 0;
 
+    /**
+     * Renews the usage timeout of the allocated card resource, which then expires after the
+     * configured usage timeout from now.
+     *
+     * <p>It allows a long-running holder to keep its card resource by renewing it periodically,
+     * while a short usage timeout still releases quickly the card resources no longer in use.
+     *
+     * <p>Nothing is renewed if no usage timeout is configured or if the card resource comes from a
+     * pool plugin.
+     *
+     * @param cardResource The allocated card resource.
+     * @throw IllegalArgumentException If the provided card resource is null.
+     * @throw IllegalStateException If the service is not started or if the card resource is not
+     *        allocated or its usage timeout already expired.
+     * @since 2.1.0
+     */
+    virtual void renewCardResource(std::shared_ptr<CardResource> cardResource) = 0;
+
+    /**
+     * Extends the usage timeout of the allocated card resource by the provided duration.
+     *
+     * <p>Nothing is extended if no usage timeout is configured or if the card resource comes from a
+     * pool plugin.
+     *
+     * @param cardResource The allocated card resource.
+     * @param durationMillis The duration to add to the current usage timeout (in milliseconds).
+     * @throw IllegalArgumentException If the provided card resource is null or if the duration is
+     *        less than 1.
+     * @throw IllegalStateException If the service is not started or if the card resource is not
+     *        allocated or its usage timeout already expired.
+     * @since 2.1.0
+     */
+    virtual void extendCardResource(std::shared_ptr<CardResource> cardResource,
+                                    const int durationMillis) = 0;
+
     /**
      * Removes the card resource and releases it if it is in use.
      *
@@ -110,6 +258,19 @@ public:
      * @since 2.0.0
      */
     virtual void removeCardResource(std::shared_ptr<CardResource> cardResource) = 0;
+
+    /**
+     * Gets a snapshot of the metrics of the card resource profiles and of the readers of the
+     * "regular" plugins.
+     *
+     * <p>The metrics are recorded without locking the allocations. Those of a card resource profile
+     * or of a reader start again from zero when it is created again, e.g. when the service is
+     * restarted.
+     *
+     * @return An empty snapshot if the service is not started.
+     * @since 2.1.0
+     */
+    virtual CardResourceServiceMetrics getMetrics() const = 0;
 };
 
 }
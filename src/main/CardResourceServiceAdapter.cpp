@@ -12,7 +12,12 @@
 
 #include "CardResourceServiceAdapter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <sstream>
+#include <thread>
+#include <unordered_set>
 
 /* Keyple Core Util */
 #include "IllegalStateException.h"
@@ -21,6 +26,7 @@
 
 /* Keyple Service Resource */
 #include "CardProfileManagerAdapter.h"
+#include "KeypleServiceResourceLog.h"
 
 /* Keyple Core Service */
 #include "ObservablePlugin.h"
@@ -38,6 +44,19 @@ using namespace keyple::core::util::cpp::exception;
 
 std::shared_ptr<CardResourceServiceAdapter> CardResourceServiceAdapter::mInstance;
 
+CardResourceServiceAdapter::CardResourceServiceAdapter()
+: mRegistry(std::make_shared<const Registry>()),
+  mIsStarted(false),
+  mIsReaderProbingCancelled(false),
+  mHasDeferredReaderProbes(false),
+  mIsReaderProbeResumingStopped(false) {}
+
+CardResourceServiceAdapter::~CardResourceServiceAdapter()
+{
+    stopReaderProbing();
+    stopReaderProbeResuming();
+}
+
 std::shared_ptr<CardResourceServiceAdapter> CardResourceServiceAdapter::getInstance()
 {
     if (mInstance == nullptr) {
@@ -68,16 +87,28 @@ const std::string CardResourceServiceAdapter::getCardResourceInfo(
     return "";
 }
 
+std::shared_ptr<const CardResourceServiceAdapter::Registry>
+    CardResourceServiceAdapter::getRegistry() const
+{
+    return std::atomic_load(&mRegistry);
+}
+
+void CardResourceServiceAdapter::publishRegistry()
+{
+    const std::lock_guard<std::mutex> lock(mRegistryMutex);
+
+    std::atomic_store(&mRegistry,
+                      std::shared_ptr<const Registry>(
+                          std::make_shared<const Registry>(mRegistryUpdate)));
+}
+
 std::shared_ptr<ReaderManagerAdapter> CardResourceServiceAdapter::getReaderManager(
     const std::shared_ptr<CardReader> reader) const
 {
-    const auto r = std::dynamic_pointer_cast<Reader>(reader);
-    if (r == nullptr) {
-        return nullptr;
-    }
-
-    const auto it = mReaderToReaderManagerMap.find(r);
-    if (it != mReaderToReaderManagerMap.end()) {
+    /* Single probe on the identity of the reader, no downcast needed */
+    const std::shared_ptr<const Registry> registry = getRegistry();
+    const auto it = registry->mReaderToReaderManagerMap.find(reader);
+    if (it != registry->mReaderToReaderManagerMap.end()) {
         return it->second;
     }
 
@@ -87,20 +118,53 @@ std::shared_ptr<ReaderManagerAdapter> CardResourceServiceAdapter::getReaderManag
 void CardResourceServiceAdapter::registerPoolCardResource(
     std::shared_ptr<CardResource> cardResource, std::shared_ptr<PoolPlugin> poolPlugin)
 {
+    const std::lock_guard<std::mutex> lock(mCardResourceToPoolPluginMutex);
+
     mCardResourceToPoolPluginMap.insert({cardResource, poolPlugin});
 }
 
+void CardResourceServiceAdapter::registerCardResource(std::shared_ptr<CardResource> cardResource,
+                                                      const std::string& cardResourceProfileName)
+{
+    const std::lock_guard<std::mutex> lock(mCardResourceToCardProfileNamesMutex);
+
+    mCardResourceToCardProfileNamesMap[cardResource].push_back(cardResourceProfileName);
+}
+
+void CardResourceServiceAdapter::onReaderLocked(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                                                std::shared_ptr<CardResource> cardResource)
+{
+    if (mUsageTimeoutReaper != nullptr) {
+        const uint64_t deadlineMillis = readerManager->getLockDeadlineMillis();
+        if (deadlineMillis != 0) {
+            mUsageTimeoutReaper->schedule(readerManager, cardResource, deadlineMillis);
+        }
+    }
+}
+
 void CardResourceServiceAdapter::configure(
     std::shared_ptr<CardResourceServiceConfiguratorAdapter> configurator)
 {
     mLogger->info("Applying a new configuration...\n");
 
-    if (mIsStarted) {
+    if (mIsStarted && haveSameGlobalSettings(*mConfigurator, *configurator)) {
+        /*
+         * The card profiles and readers of the current configuration must be complete, the
+         * background probing completing them under the lock.
+         */
+        if (mReaderProbingThread.joinable()) {
+            mReaderProbingThread.join();
+        }
+
+        /* Serialized with the plugin and reader events modifying the same maps */
+        const std::lock_guard<std::mutex> lock(mMutex);
+        applyConfigurationChanges(configurator);
+    } else if (mIsStarted) {
         stop();
-        mConfigurator = configurator;
+        std::atomic_store(&mConfigurator, configurator);
         start();
     } else {
-        mConfigurator = configurator;
+        std::atomic_store(&mConfigurator, configurator);
     }
 
     mLogger->info("New configuration applied\n");
@@ -124,9 +188,48 @@ void CardResourceServiceAdapter::start()
     mLogger->info("Starting...\n");
 
     initializeReaderManagers();
-    initializeCardProfileManagers();
-    removeUnusedReaderManagers();
-    startMonitoring();
+    std::vector<ReaderProbe> readerProbes =
+        initializeCardProfileManagers(mConfigurator->getCardResourceProfileConfigurators());
+    mIsReaderProbingCancelled = false;
+    {
+        const std::lock_guard<std::mutex> lock(mDeferredReaderProbesMutex);
+        mIsReaderProbeResumingStopped = false;
+    }
+
+    if (!mConfigurator->getPlugins().empty() && mConfigurator->getUsageTimeoutMillis() > 0) {
+        mUsageTimeoutObserverSpi = mConfigurator->getUsageTimeoutObserverSpi();
+        mUsageTimeoutReaper.reset(new UsageTimeoutReaper(
+            [this](std::shared_ptr<ReaderManagerAdapter> readerManager,
+                   std::shared_ptr<CardResource> cardResource,
+                   const uint64_t deadlineMillis) {
+                onUsageTimeout(readerManager, cardResource, deadlineMillis);
+            }));
+    }
+
+    if (mConfigurator->isBackgroundReaderProbing()) {
+        /*
+         * The service is available at once, the card resources being added as their readers are
+         * probed. The unused reader managers are kept, the reader managers map being read by the
+         * allocating threads.
+         */
+        mIsStarted = true;
+        mReaderProbingThread = std::thread(&CardResourceServiceAdapter::probeReadersInBackground,
+                                           this,
+                                           std::move(readerProbes));
+    } else {
+        probeReaders(readerProbes);
+
+        for (const auto& readerProbe : readerProbes) {
+            if (readerProbe.mException != nullptr) {
+                std::rethrow_exception(readerProbe.mException);
+            }
+        }
+
+        completeReaderProbes(readerProbes);
+        removeUnusedReaderManagers();
+        startMonitoring();
+    }
+
     mIsStarted = true;
 
     mLogger->info("Started\n");
@@ -136,21 +239,164 @@ void CardResourceServiceAdapter::stop()
 {
     mIsStarted = false;
 
+    stopReaderProbing();
     stopMonitoring();
+    stopReaderProbeResuming();
+
+    /* Waits for the end of an ongoing expiration before clearing the reader managers */
+    mUsageTimeoutReaper.reset();
+    mUsageTimeoutObserverSpi = nullptr;
+
+    mRegistryUpdate.mReaderToReaderManagerMap.clear();
+    mRegistryUpdate.mReaderNameToReaderManagerMap.clear();
+    for (const auto& entry : mRegistryUpdate.mCardProfileNameToCardProfileManagerMap) {
+        entry.second->stop();
+    }
+
+    mRegistryUpdate.mCardProfileNameToCardProfileManagerMap.clear();
+    publishRegistry();
+    {
+        const std::lock_guard<std::mutex> lock(mCardResourceToPoolPluginMutex);
+        mCardResourceToPoolPluginMap.clear();
+    }
 
-    mReaderToReaderManagerMap.clear();
-    mCardProfileNameToCardProfileManagerMap.clear();
-    mCardResourceToPoolPluginMap.clear();
     mPluginToObservableReadersMap.clear();
 
+    {
+        const std::lock_guard<std::mutex> lock(mCardResourceToCardProfileNamesMutex);
+        mCardResourceToCardProfileNamesMap.clear();
+    }
+
     mLogger->info("Stopped\n");
 }
 
 std::shared_ptr<CardResource> CardResourceServiceAdapter::getCardResource(
     const std::string& cardResourceProfileName) const
 {
-    mLogger->debug("Searching a card resource for profile '%'...\n", cardResourceProfileName);
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger,
+                                    "Searching a card resource for profile '%'...\n",
+                                    cardResourceProfileName);
+
+    std::shared_ptr<CardResource> cardResource =
+        getCardProfileManager(cardResourceProfileName)->getCardResource();
+
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Found : %\n", getCardResourceInfo(cardResource));
+
+    return cardResource;
+}
+
+void CardResourceServiceAdapter::getCardResourceAsync(
+    const std::string& cardResourceProfileName,
+    std::function<void(std::shared_ptr<CardResource>)> callback) const
+{
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger,
+                                    "Requesting a card resource for profile '%'...\n",
+                                    cardResourceProfileName);
 
+    std::shared_ptr<CardProfileManagerAdapter> cardProfileManager =
+        getCardProfileManager(cardResourceProfileName);
+
+    if (!callback) {
+        throw IllegalArgumentException("The callback is null.");
+    }
+
+    cardProfileManager->getCardResource(callback);
+}
+
+std::future<std::shared_ptr<CardResource>> CardResourceServiceAdapter::getCardResourceAsync(
+    const std::string& cardResourceProfileName) const
+{
+    auto promise = std::make_shared<std::promise<std::shared_ptr<CardResource>>>();
+    std::future<std::shared_ptr<CardResource>> future = promise->get_future();
+
+    getCardResourceAsync(cardResourceProfileName,
+                         [promise](std::shared_ptr<CardResource> cardResource) {
+                             promise->set_value(cardResource);
+                         });
+
+    return future;
+}
+
+const std::vector<std::shared_ptr<CardResource>> CardResourceServiceAdapter::getCardResources(
+    const std::string& cardResourceProfileName, const int count)
+{
+    Assert::getInstance().greaterOrEqual(count, 1, "count");
+
+    return getCardResources(std::vector<std::string>(count, cardResourceProfileName));
+}
+
+const std::vector<std::shared_ptr<CardResource>> CardResourceServiceAdapter::getCardResources(
+    const std::vector<std::string>& cardResourceProfileNames)
+{
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger,
+                                    "Searching % card resources...\n",
+                                    cardResourceProfileNames.size());
+
+    Assert::getInstance().notEmpty(cardResourceProfileNames, "cardResourceProfileNames");
+
+    std::vector<std::shared_ptr<CardProfileManagerAdapter>> cardProfileManagers;
+    for (const auto& cardResourceProfileName : cardResourceProfileNames) {
+        cardProfileManagers.push_back(getCardProfileManager(cardResourceProfileName));
+    }
+
+    const std::shared_ptr<CardResourceServiceConfiguratorAdapter> configurator =
+        std::atomic_load(&mConfigurator);
+    const std::chrono::steady_clock::time_point requestTime = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point maxTime =
+        requestTime + std::chrono::milliseconds(configurator->getTimeoutMillis());
+
+    std::vector<std::shared_ptr<CardResource>> cardResources;
+    cardResources.reserve(cardProfileManagers.size());
+
+    while (true) {
+        /* Single pass over all the requested profiles */
+        std::shared_ptr<CardProfileManagerAdapter> missingCardProfileManager = nullptr;
+        for (const auto& cardProfileManager : cardProfileManagers) {
+            std::shared_ptr<CardResource> cardResource = cardProfileManager->tryGetCardResource();
+            if (cardResource == nullptr) {
+                missingCardProfileManager = cardProfileManager;
+                break;
+            }
+            cardResources.push_back(cardResource);
+        }
+
+        if (missingCardProfileManager == nullptr) {
+            break;
+        }
+
+        /* Never hold a partial allocation, others may need it to complete theirs */
+        for (auto it = cardResources.rbegin(); it != cardResources.rend(); ++it) {
+            releaseCardResource(*it);
+        }
+        cardResources.clear();
+
+        if (!configurator->isBlockingAllocationMode() ||
+            std::chrono::steady_clock::now() >= maxTime) {
+            break;
+        }
+
+        /* Retry only when the missing profile can satisfy its whole share of the request */
+        missingCardProfileManager->waitForCardResources(
+            std::count(cardProfileManagers.begin(),
+                       cardProfileManagers.end(),
+                       missingCardProfileManager),
+            maxTime);
+    }
+
+    /* The batch is either complete or empty */
+    for (std::size_t i = 0; i < cardProfileManagers.size(); i++) {
+        cardProfileManagers[i]->recordAllocation(
+            requestTime, cardResources.empty() ? nullptr : cardResources[i]);
+    }
+
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Found : % card resource(s)\n", cardResources.size());
+
+    return cardResources;
+}
+
+std::shared_ptr<CardProfileManagerAdapter> CardResourceServiceAdapter::getCardProfileManager(
+    const std::string& cardResourceProfileName) const
+{
     if (!mIsStarted) {
         throw IllegalStateException("The card resource service is not started.");
     }
@@ -158,23 +404,52 @@ std::shared_ptr<CardResource> CardResourceServiceAdapter::getCardResource(
     Assert::getInstance().notEmpty(cardResourceProfileName, "cardResourceProfileName");
 
     std::shared_ptr<CardProfileManagerAdapter> cardProfileManager = nullptr;
-    const auto& it = mCardProfileNameToCardProfileManagerMap.find(cardResourceProfileName);
-    if (it != mCardProfileNameToCardProfileManagerMap.end()) {
+    const std::shared_ptr<const Registry> registry = getRegistry();
+    const auto& it =
+        registry->mCardProfileNameToCardProfileManagerMap.find(cardResourceProfileName);
+    if (it != registry->mCardProfileNameToCardProfileManagerMap.end()) {
         cardProfileManager = it->second;
     }
 
     Assert::getInstance().notNull(cardProfileManager, "cardResourceProfileName");
 
-    std::shared_ptr<CardResource> cardResource = cardProfileManager->getCardResource();
+    return cardProfileManager;
+}
 
-    mLogger->debug("Found : %\n", getCardResourceInfo(cardResource));
+CardResourceServiceMetrics CardResourceServiceAdapter::getMetrics() const
+{
+    if (!mIsStarted) {
+        return CardResourceServiceMetrics();
+    }
 
-    return cardResource;
+    /* The card profiles and readers being removed meanwhile are not reported */
+    const std::lock_guard<std::mutex> lock(mRegistryMutex);
+    const std::shared_ptr<const Registry> registry = getRegistry();
+
+    std::vector<CardResourceServiceMetrics::ProfileMetrics> profileMetrics;
+    profileMetrics.reserve(registry->mCardProfileNameToCardProfileManagerMap.size());
+    for (const auto& pair : registry->mCardProfileNameToCardProfileManagerMap) {
+        profileMetrics.push_back(pair.second->getMetrics());
+    }
+
+    std::vector<CardResourceServiceMetrics::ReaderMetrics> readerMetrics;
+    readerMetrics.reserve(registry->mReaderToReaderManagerMap.size());
+    for (const auto& pair : registry->mReaderToReaderManagerMap) {
+        readerMetrics.push_back(pair.second->getMetrics());
+    }
+
+    uint64_t poolAllocationCount;
+    {
+        const std::lock_guard<std::mutex> poolLock(mCardResourceToPoolPluginMutex);
+        poolAllocationCount = mCardResourceToPoolPluginMap.size();
+    }
+
+    return CardResourceServiceMetrics(profileMetrics, readerMetrics, poolAllocationCount);
 }
 
 void CardResourceServiceAdapter::releaseCardResource(std::shared_ptr<CardResource> cardResource)
 {
-    mLogger->debug("Releasing %...\n", getCardResourceInfo(cardResource));
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Releasing %...\n", getCardResourceInfo(cardResource));
 
     if (!mIsStarted) {
         throw IllegalStateException("The card resource service is not started.");
@@ -190,48 +465,195 @@ void CardResourceServiceAdapter::releaseCardResource(std::shared_ptr<CardResourc
         throw IllegalArgumentException("Invalid reader");
     }
 
-    const auto it = mReaderToReaderManagerMap.find(reader);
-    if (it != mReaderToReaderManagerMap.end()) {
+    const std::shared_ptr<const Registry> registry = getRegistry();
+    const auto it = registry->mReaderToReaderManagerMap.find(reader);
+    if (it != registry->mReaderToReaderManagerMap.end()) {
         readerManager = it->second;
-        readerManager->unlock();
+        releaseReader(readerManager);
     } else {
-        std::shared_ptr<PoolPlugin> poolPlugin = nullptr;
-        const auto itt = mCardResourceToPoolPluginMap.find(cardResource);
-        if (itt != mCardResourceToPoolPluginMap.end()) {
-            poolPlugin = itt->second;
-            mCardResourceToPoolPluginMap.erase(cardResource);
-            poolPlugin->releaseReader(reader);
+        releasePoolCardResource(cardResource);
+    }
+
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Card resource released\n");
+}
+
+CardResourceLease CardResourceServiceAdapter::acquireCardResource(
+    const std::string& cardResourceProfileName)
+{
+    const std::shared_ptr<CardResource> cardResource = getCardResource(cardResourceProfileName);
+    if (cardResource == nullptr) {
+        return CardResourceLease();
+    }
+
+    /* The lookup is done once here, the release of the lease using its result directly */
+    std::shared_ptr<ReaderManagerAdapter> readerManager =
+        getReaderManager(cardResource->getReader());
+
+    /* The lock owned by the lease, to release it only once */
+    const uint64_t lockDeadlineMillis =
+        readerManager != nullptr ? readerManager->getLockDeadlineMillis() : 0;
+
+    return CardResourceLease(shared_from_this(), cardResource, readerManager, lockDeadlineMillis);
+}
+
+void CardResourceServiceAdapter::releaseLeasedCardResource(
+    const std::shared_ptr<CardResource>& cardResource,
+    const std::shared_ptr<ReaderManagerAdapter>& readerManager,
+    const uint64_t lockDeadlineMillis)
+{
+    /* The card resources allocated before the stop of the service are no longer managed */
+    if (!mIsStarted) {
+        return;
+    }
+
+    try {
+        if (readerManager != nullptr) {
+            if (readerManager->takeOverLock(lockDeadlineMillis)) {
+                releaseReader(readerManager);
+            } else {
+                KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger,
+                                                "% already released\n",
+                                                getCardResourceInfo(cardResource));
+            }
+        } else {
+            releasePoolCardResource(cardResource);
         }
+    } catch (const std::exception& e) {
+        mLogger->error("Unable to release the card resource of the reader '%': %\n",
+                       cardResource->getReader()->getName(),
+                       e.what());
+    }
+}
+
+void CardResourceServiceAdapter::renewCardResource(std::shared_ptr<CardResource> cardResource)
+{
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Renewing %...\n", getCardResourceInfo(cardResource));
+
+    if (!mIsStarted) {
+        throw IllegalStateException("The card resource service is not started.");
+    }
+
+    Assert::getInstance().notNull(cardResource, "cardResource");
+
+    extendUsageTimeout(cardResource,
+                       getReaderManager(cardResource->getReader()),
+                       0,
+                       std::atomic_load(&mConfigurator)->getUsageTimeoutMillis(),
+                       true);
+
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Card resource renewed\n");
+}
+
+uint64_t CardResourceServiceAdapter::renewLeasedCardResource(
+    const std::shared_ptr<CardResource>& cardResource,
+    const std::shared_ptr<ReaderManagerAdapter>& readerManager,
+    const uint64_t lockDeadlineMillis)
+{
+    if (!mIsStarted) {
+        throw IllegalStateException("The card resource service is not started.");
+    }
+
+    return extendUsageTimeout(cardResource,
+                              readerManager,
+                              lockDeadlineMillis,
+                              std::atomic_load(&mConfigurator)->getUsageTimeoutMillis(),
+                              true);
+}
+
+void CardResourceServiceAdapter::extendCardResource(std::shared_ptr<CardResource> cardResource,
+                                                    const int durationMillis)
+{
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger,
+                                    "Extending % by % milliseconds...\n",
+                                    getCardResourceInfo(cardResource),
+                                    durationMillis);
+
+    if (!mIsStarted) {
+        throw IllegalStateException("The card resource service is not started.");
+    }
+
+    Assert::getInstance().notNull(cardResource, "cardResource")
+                         .greaterOrEqual(durationMillis, 1, "durationMillis");
+
+    extendUsageTimeout(cardResource,
+                       getReaderManager(cardResource->getReader()),
+                       0,
+                       durationMillis,
+                       false);
+
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Card resource extended\n");
+}
+
+uint64_t CardResourceServiceAdapter::extendLeasedCardResource(
+    const std::shared_ptr<CardResource>& cardResource,
+    const std::shared_ptr<ReaderManagerAdapter>& readerManager,
+    const uint64_t lockDeadlineMillis,
+    const int durationMillis)
+{
+    if (!mIsStarted) {
+        throw IllegalStateException("The card resource service is not started.");
     }
 
-    mLogger->debug("Card resource released\n");
+    Assert::getInstance().greaterOrEqual(durationMillis, 1, "durationMillis");
+
+    return extendUsageTimeout(cardResource,
+                              readerManager,
+                              lockDeadlineMillis,
+                              durationMillis,
+                              false);
 }
 
 void CardResourceServiceAdapter::removeCardResource(std::shared_ptr<CardResource> cardResource)
 {
-    mLogger->debug("Removing %...\n", getCardResourceInfo(cardResource));
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Removing %...\n", getCardResourceInfo(cardResource));
 
-    releaseCardResource(cardResource);
+    if (!mIsStarted) {
+        throw IllegalStateException("The card resource service is not started.");
+    }
+
+    Assert::getInstance().notNull(cardResource, "cardResource");
 
     /* For regular plugin ? */
     std::shared_ptr<ReaderManagerAdapter> readerManager = nullptr;
 
-    const auto r = std::dynamic_pointer_cast<Reader>(cardResource->getReader());
-    if (r == nullptr) {
+    const auto reader = cardResource->getReader();
+    if (reader == nullptr) {
         throw IllegalArgumentException("Invalid reader");
     }
 
-    const auto it = mReaderToReaderManagerMap.find(r);
-    if (it != mReaderToReaderManagerMap.end()) {
+    const std::shared_ptr<const Registry> registry = getRegistry();
+    const auto it = registry->mReaderToReaderManagerMap.find(reader);
+    if (it != registry->mReaderToReaderManagerMap.end()) {
         readerManager = it->second;
         readerManager->removeCardResource(cardResource);
 
-        for (auto& pair : mCardProfileNameToCardProfileManagerMap) {
-            pair.second->removeCardResource(cardResource);
+        /* Only the card profiles referencing the card resource are involved */
+        std::vector<std::string> cardResourceProfileNames;
+        {
+            const std::lock_guard<std::mutex> lock(mCardResourceToCardProfileNamesMutex);
+            const auto itn = mCardResourceToCardProfileNamesMap.find(cardResource);
+            if (itn != mCardResourceToCardProfileNamesMap.end()) {
+                cardResourceProfileNames.swap(itn->second);
+                mCardResourceToCardProfileNamesMap.erase(itn);
+            }
+        }
+
+        for (const auto& cardResourceProfileName : cardResourceProfileNames) {
+            const auto itp =
+                registry->mCardProfileNameToCardProfileManagerMap.find(cardResourceProfileName);
+            if (itp != registry->mCardProfileNameToCardProfileManagerMap.end()) {
+                itp->second->removeCardResource(cardResource);
+            }
         }
     }
 
-    mLogger->debug("Card resource removed\n");
+    /*
+     * Released once no longer referenced, so that it cannot be handed over to a waiter, only the
+     * other card resources of the reader becoming available.
+     */
+    releaseCardResource(cardResource);
+
+    KEYPLESERVICERESOURCE_LOG_DEBUG(mLogger, "Card resource removed\n");
 }
 
 void CardResourceServiceAdapter::onPluginEvent(const std::shared_ptr<PluginEvent> pluginEvent)
@@ -281,20 +703,30 @@ void CardResourceServiceAdapter::onReaderEvent(const std::shared_ptr<CardReaderE
 
         /* The reader is registered in the service */
         const std::lock_guard<std::mutex> lock(mMutex);
-        const auto it = mReaderToReaderManagerMap.find(reader);
-        if (it != mReaderToReaderManagerMap.end()) {
+        const auto it = mRegistryUpdate.mReaderToReaderManagerMap.find(reader);
+        if (it != mRegistryUpdate.mReaderToReaderManagerMap.end()) {
             onReaderEvent(readerEvent, it->second);
         }
     }
 }
 
-void CardResourceServiceAdapter::initializeReaderManagers()
+std::vector<std::shared_ptr<ReaderManagerAdapter>>
+    CardResourceServiceAdapter::initializeReaderManagers()
 {
+    std::vector<std::shared_ptr<ReaderManagerAdapter>> readerManagers;
+
     for (const auto& plugin : mConfigurator->getPlugins()) {
         for (const auto& reader : plugin->getReaders()) {
-            registerReader(reader, plugin);
+            if (mRegistryUpdate.mReaderToReaderManagerMap.find(reader) ==
+                mRegistryUpdate.mReaderToReaderManagerMap.end()) {
+                readerManagers.push_back(registerReader(reader, plugin));
+            }
         }
     }
+
+    publishRegistry();
+
+    return readerManagers;
 }
 
 std::shared_ptr<ReaderManagerAdapter> CardResourceServiceAdapter::registerReader(
@@ -315,7 +747,8 @@ std::shared_ptr<ReaderManagerAdapter> CardResourceServiceAdapter::registerReader
                                                readerConfiguratorSpi,
                                                mConfigurator->getUsageTimeoutMillis());
 
-    mReaderToReaderManagerMap.insert({reader, readerManager});
+    mRegistryUpdate.mReaderToReaderManagerMap.insert({reader, readerManager});
+    mRegistryUpdate.mReaderNameToReaderManagerMap.insert({reader->getName(), readerManager});
 
     const auto observable = std::dynamic_pointer_cast<ObservableCardReader>(reader);
     if (observable) {
@@ -334,33 +767,661 @@ std::shared_ptr<ReaderManagerAdapter> CardResourceServiceAdapter::registerReader
     return readerManager;
 }
 
-void CardResourceServiceAdapter::initializeCardProfileManagers()
+std::vector<CardResourceServiceAdapter::ReaderProbe>
+    CardResourceServiceAdapter::initializeCardProfileManagers(
+        const std::vector<std::shared_ptr<CardResourceProfileConfigurator>>& cardProfiles)
+{
+    std::vector<std::shared_ptr<CardProfileManagerAdapter>> cardProfileManagers;
+    for (const auto& profile : cardProfiles) {
+        auto cardProfileManager =
+            std::make_shared<CardProfileManagerAdapter>(profile, mConfigurator);
+        mRegistryUpdate.mCardProfileNameToCardProfileManagerMap.insert(
+            {profile->getProfileName(), cardProfileManager});
+        cardProfileManagers.push_back(cardProfileManager);
+    }
+
+    publishRegistry();
+
+    /*
+     * Group the work by reader, a reader being probed by a single thread. For each card profile,
+     * keep the rank of the reader in its configured order of readers.
+     */
+    std::vector<ReaderProbe> readerProbes;
+    std::unordered_map<const ReaderManagerAdapter*, std::size_t> readerProbeIndexes;
+
+    for (const auto& cardProfileManager : cardProfileManagers) {
+        uint64_t rank = 1;
+        for (const auto& readerManager : cardProfileManager->getAcceptedReaderManagers()) {
+            const auto result =
+                readerProbeIndexes.insert({readerManager.get(), readerProbes.size()});
+            if (result.second) {
+                readerProbes.push_back(ReaderProbe());
+                readerProbes.back().mReaderManager = readerManager;
+            }
+
+            ReaderProbe& readerProbe = readerProbes[result.first->second];
+            readerProbe.mCardProfileManagers.push_back(cardProfileManager);
+            readerProbe.mCardResourceRanks.push_back(rank++);
+        }
+    }
+
+    return readerProbes;
+}
+
+void CardResourceServiceAdapter::probeReaders(std::vector<ReaderProbe>& readerProbes) const
+{
+    std::atomic<std::size_t> nextReaderProbe(0);
+    const auto worker = [this, &readerProbes, &nextReaderProbe] {
+        std::size_t i;
+        while (!mIsReaderProbingCancelled && (i = nextReaderProbe++) < readerProbes.size()) {
+            probeReader(readerProbes[i], false);
+        }
+    };
+
+    const std::size_t workerCount =
+        std::min<std::size_t>(readerProbes.size(),
+                              std::max<std::size_t>(1, std::thread::hardware_concurrency()));
+
+    mLogger->debug("Probing % readers using % threads\n", readerProbes.size(), workerCount);
+
+    /* The calling thread is one of the workers */
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < workerCount; i++) {
+        workers.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+void CardResourceServiceAdapter::probeReadersInBackground(std::vector<ReaderProbe> readerProbes)
+{
+    probeReaders(readerProbes);
+
+    {
+        /* Serialized with the plugin and reader events, as soon as the monitoring starts */
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        if (!mIsStarted || mIsReaderProbingCancelled) {
+            mLogger->debug("Background probing of the readers cancelled\n");
+            return;
+        }
+
+        completeReaderProbes(readerProbes);
+        startMonitoring();
+    }
+
+    mLogger->info("Background probing of % readers completed\n", readerProbes.size());
+}
+
+void CardResourceServiceAdapter::stopReaderProbing()
+{
+    if (mReaderProbingThread.joinable()) {
+        mIsReaderProbingCancelled = true;
+        mReaderProbingThread.join();
+    }
+}
+
+void CardResourceServiceAdapter::completeReaderProbes(std::vector<ReaderProbe>& readerProbes)
 {
-    for (const auto& profile : mConfigurator->getCardResourceProfileConfigurators()) {
-        mCardProfileNameToCardProfileManagerMap.insert({
-            profile->getProfileName(),
-            std::make_shared<CardProfileManagerAdapter>(profile, mConfigurator)});
+    for (auto& readerProbe : readerProbes) {
+        if (readerProbe.mException != nullptr) {
+            try {
+                std::rethrow_exception(readerProbe.mException);
+            } catch (const std::exception& e) {
+                mLogger->error("Unable to probe reader '%': %\n",
+                               readerProbe.mReaderManager->getReader()->getName(),
+                               e.what());
+            }
+        } else if (readerProbe.mProbedCount < readerProbe.mCardProfileManagers.size()) {
+            mLogger->debug("Reader '%' in use, its probing is postponed until its release\n",
+                           readerProbe.mReaderManager->getReader()->getName());
+
+            const std::lock_guard<std::mutex> lock(mDeferredReaderProbesMutex);
+            if (mIsReaderProbeResumingStopped) {
+                continue;
+            }
+
+            mDeferredReaderProbes[readerProbe.mReaderManager.get()] = std::move(readerProbe);
+            mHasDeferredReaderProbes = true;
+
+            if (!mReaderProbeResumingThread.joinable()) {
+                mReaderProbeResumingThread =
+                    std::thread(&CardResourceServiceAdapter::resumeReaderProbes, this);
+            }
+        }
+    }
+}
+
+uint64_t CardResourceServiceAdapter::extendUsageTimeout(
+    std::shared_ptr<CardResource> cardResource,
+    std::shared_ptr<ReaderManagerAdapter> readerManager,
+    const uint64_t lockDeadlineMillis,
+    const int durationMillis,
+    const bool isFromNow)
+{
+    /* Only the card resources of the "regular" plugins have a usage timeout */
+    if (readerManager == nullptr) {
+        return 0;
+    }
+
+    const uint64_t deadlineMillis = readerManager->extendLock(
+        lockDeadlineMillis, static_cast<uint64_t>(durationMillis), isFromNow);
+    if (deadlineMillis == 0) {
+        throw IllegalStateException("The card resource is not allocated or its usage timeout " \
+                                    "already expired.");
+    }
+
+    /* The timer of the previous deadline is ignored when it expires */
+    if (mUsageTimeoutReaper != nullptr &&
+        deadlineMillis != ReaderManagerAdapter::LOCKED_WITHOUT_TIMEOUT) {
+        mUsageTimeoutReaper->schedule(readerManager, cardResource, deadlineMillis);
+    }
+
+    return deadlineMillis != ReaderManagerAdapter::LOCKED_WITHOUT_TIMEOUT ? deadlineMillis : 0;
+}
+
+void CardResourceServiceAdapter::releasePoolCardResource(
+    const std::shared_ptr<CardResource>& cardResource)
+{
+    /* The entry is removed once, a card resource being released only once */
+    std::shared_ptr<PoolPlugin> poolPlugin = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(mCardResourceToPoolPluginMutex);
+        const auto it = mCardResourceToPoolPluginMap.find(cardResource);
+        if (it == mCardResourceToPoolPluginMap.end()) {
+            return;
+        }
+
+        poolPlugin = it->second;
+        mCardResourceToPoolPluginMap.erase(it);
+    }
+
+    poolPlugin->releaseReader(cardResource->getReader());
+
+    /* Wake up the threads waiting for a card resource */
+    if (std::atomic_load(&mConfigurator)->isBlockingAllocationMode()) {
+        const std::shared_ptr<const Registry> registry = getRegistry();
+        for (const auto& pair : registry->mCardProfileNameToCardProfileManagerMap) {
+            pair.second->notifyCardResourceAvailable();
+        }
+    }
+}
+
+void CardResourceServiceAdapter::releaseReader(std::shared_ptr<ReaderManagerAdapter> readerManager)
+{
+    /* A postponed probing of the reader takes it over, its card resources being freed after it */
+    if (mHasDeferredReaderProbes && resumeReaderProbe(readerManager)) {
+        return;
+    }
+
+    readerManager->unlock();
+
+    /* Make the card resources of the reader free again and wake up the waiting threads */
+    const std::shared_ptr<const Registry> registry = getRegistry();
+    for (const auto& pair : registry->mCardProfileNameToCardProfileManagerMap) {
+        pair.second->onReaderUnlocked(readerManager);
+    }
+}
+
+void CardResourceServiceAdapter::onUsageTimeout(
+    std::shared_ptr<ReaderManagerAdapter> readerManager,
+    std::shared_ptr<CardResource> cardResource,
+    const uint64_t deadlineMillis)
+{
+    /* The card resource may have been released, and its reader allocated again, meanwhile */
+    if (!readerManager->expireLock(deadlineMillis)) {
+        return;
+    }
+
+    releaseReader(readerManager);
+
+    if (mUsageTimeoutObserverSpi != nullptr) {
+        mUsageTimeoutObserverSpi->onUsageTimeout(cardResource);
+    }
+}
+
+bool CardResourceServiceAdapter::resumeReaderProbe(
+    std::shared_ptr<ReaderManagerAdapter> readerManager)
+{
+    ReaderProbe readerProbe;
+    {
+        const std::lock_guard<std::mutex> lock(mDeferredReaderProbesMutex);
+
+        const auto it = mDeferredReaderProbes.find(readerManager.get());
+        if (it == mDeferredReaderProbes.end()) {
+            return false;
+        }
+
+        mResumedReaderProbes.push_back(std::move(it->second));
+        mDeferredReaderProbes.erase(it);
+        mHasDeferredReaderProbes = !mDeferredReaderProbes.empty();
+    }
+
+    mResumedReaderProbesCondition.notify_all();
+
+    return true;
+}
+
+void CardResourceServiceAdapter::resumeReaderProbes()
+{
+    std::unique_lock<std::mutex> lock(mDeferredReaderProbesMutex);
+
+    /* A thread detached by a stop from one of its callbacks ends, even if the service restarts */
+    const auto isStopped = [this] {
+        return mIsReaderProbeResumingStopped ||
+               mReaderProbeResumingThread.get_id() != std::this_thread::get_id();
+    };
+
+    while (true) {
+        mResumedReaderProbesCondition.wait(lock, [this, &isStopped] {
+            return isStopped() || !mResumedReaderProbes.empty();
+        });
+
+        if (isStopped()) {
+            return;
+        }
+
+        std::vector<ReaderProbe> readerProbes;
+        readerProbes.push_back(std::move(mResumedReaderProbes.front()));
+        mResumedReaderProbes.pop_front();
+
+        lock.unlock();
+
+        const std::shared_ptr<ReaderManagerAdapter> readerManager =
+            readerProbes.back().mReaderManager;
+
+        mLogger->debug("Resume the probing of reader '%'\n", readerManager->getReader()->getName());
+
+        /* The card profiles of the probing may have been removed meanwhile */
+        if (readerProbes.back().mProbedCount < readerProbes.back().mCardProfileManagers.size()) {
+            probeReader(readerProbes.back(), true);
+            completeReaderProbes(readerProbes);
+        } else {
+            readerManager->unlock();
+        }
+
+        /* Make the card resources of the reader free again and wake up the waiting threads */
+        const std::shared_ptr<const Registry> registry = getRegistry();
+        for (const auto& pair : registry->mCardProfileNameToCardProfileManagerMap) {
+            pair.second->onReaderUnlocked(readerManager);
+        }
+
+        lock.lock();
+    }
+}
+
+void CardResourceServiceAdapter::stopReaderProbeResuming()
+{
+    std::thread readerProbeResumingThread;
+    {
+        const std::lock_guard<std::mutex> lock(mDeferredReaderProbesMutex);
+        mIsReaderProbeResumingStopped = true;
+        mDeferredReaderProbes.clear();
+        mResumedReaderProbes.clear();
+        mHasDeferredReaderProbes = false;
+        readerProbeResumingThread = std::move(mReaderProbeResumingThread);
+    }
+
+    mResumedReaderProbesCondition.notify_all();
+
+    if (!readerProbeResumingThread.joinable()) {
+        return;
+    }
+
+    /* The service may be stopped by a callback of the resuming thread itself */
+    if (readerProbeResumingThread.get_id() == std::this_thread::get_id()) {
+        readerProbeResumingThread.detach();
+    } else {
+        readerProbeResumingThread.join();
+    }
+}
+
+void CardResourceServiceAdapter::removeDeferredReaderProbes(
+    const std::vector<std::shared_ptr<CardProfileManagerAdapter>>& cardProfileManagers)
+{
+    /* Only the card profile managers not probed yet are involved */
+    const auto removeCardProfileManagers = [&cardProfileManagers](ReaderProbe& readerProbe) {
+        std::size_t i = readerProbe.mProbedCount;
+        while (i < readerProbe.mCardProfileManagers.size()) {
+            if (std::find(cardProfileManagers.begin(),
+                          cardProfileManagers.end(),
+                          readerProbe.mCardProfileManagers[i]) != cardProfileManagers.end()) {
+                readerProbe.mCardProfileManagers.erase(
+                    readerProbe.mCardProfileManagers.begin() + i);
+                readerProbe.mCardResourceRanks.erase(readerProbe.mCardResourceRanks.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    };
+
+    const std::lock_guard<std::mutex> lock(mDeferredReaderProbesMutex);
+
+    for (auto it = mDeferredReaderProbes.begin(); it != mDeferredReaderProbes.end();) {
+        removeCardProfileManagers(it->second);
+
+        if (it->second.mProbedCount == it->second.mCardProfileManagers.size()) {
+            it = mDeferredReaderProbes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    /* The resumed probings are kept, their reader being unlocked by the resuming thread */
+    for (auto& readerProbe : mResumedReaderProbes) {
+        removeCardProfileManagers(readerProbe);
+    }
+
+    mHasDeferredReaderProbes = !mDeferredReaderProbes.empty();
+}
+
+void CardResourceServiceAdapter::probeReader(ReaderProbe& readerProbe, bool isReaderLocked)
+{
+    try {
+        readerProbe.mReaderManager->activate();
+
+        while (readerProbe.mProbedCount < readerProbe.mCardProfileManagers.size()) {
+            /* The reader may be in use through the card profiles in which it is already added */
+            if (!isReaderLocked && !readerProbe.mReaderManager->tryLock()) {
+                return;
+            }
+
+            isReaderLocked = false;
+
+            const std::size_t i = readerProbe.mProbedCount++;
+            const std::shared_ptr<CardResource> cardResource =
+                readerProbe.mCardProfileManagers[i]->probeReader(readerProbe.mReaderManager);
+            if (cardResource != nullptr) {
+                readerProbe.mCardProfileManagers[i]->addCardResource(
+                    readerProbe.mReaderManager, cardResource, readerProbe.mCardResourceRanks[i]);
+            }
+        }
+    } catch (...) {
+        readerProbe.mException = std::current_exception();
     }
 }
 
 void CardResourceServiceAdapter::removeUnusedReaderManagers()
 {
+    std::unordered_set<const ReaderManagerAdapter*> usedReaderManagers;
+    for (const auto& pair : mRegistryUpdate.mCardProfileNameToCardProfileManagerMap) {
+        for (const auto& readerManager : pair.second->getAcceptedReaderManagers()) {
+            usedReaderManagers.insert(readerManager.get());
+        }
+    }
+
     std::vector<std::shared_ptr<ReaderManagerAdapter>> readerManagers;
-    for (const auto& pair : mReaderToReaderManagerMap) {
-        readerManagers.push_back(pair.second);
+    for (const auto& pair : mRegistryUpdate.mReaderToReaderManagerMap) {
+        if (usedReaderManagers.find(pair.second.get()) == usedReaderManagers.end()) {
+            readerManagers.push_back(pair.second);
+        }
     }
 
     for (const auto& readerManager : readerManagers) {
-        if (!readerManager->isActive()) {
+        onCardRemoved(readerManager);
+        unregisterReader(readerManager->getReader(), readerManager->getPlugin());
+    }
+
+    publishRegistry();
+}
+
+void CardResourceServiceAdapter::applyConfigurationChanges(
+    std::shared_ptr<CardResourceServiceConfiguratorAdapter> configurator)
+{
+    /* Regular plugins removed or configured differently, and the new ones */
+    std::vector<std::shared_ptr<ConfiguredPlugin>> removedPlugins;
+    for (const auto& configuredPlugin : mConfigurator->getConfiguredPlugins()) {
+        if (!containsConfiguredPlugin(configurator->getConfiguredPlugins(), configuredPlugin)) {
+            removedPlugins.push_back(configuredPlugin);
+        }
+    }
+
+    std::vector<std::shared_ptr<ConfiguredPlugin>> addedPlugins;
+    for (const auto& configuredPlugin : configurator->getConfiguredPlugins()) {
+        if (!containsConfiguredPlugin(mConfigurator->getConfiguredPlugins(), configuredPlugin)) {
+            addedPlugins.push_back(configuredPlugin);
+        }
+    }
+
+    const auto isPluginRemoved = [&removedPlugins](const std::shared_ptr<Plugin>& plugin) {
+        for (const auto& configuredPlugin : removedPlugins) {
+            if (configuredPlugin->getPlugin() == plugin) {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    /* The card profiles without plugins are involved by any change of the global plugins */
+    const bool areGlobalPluginsUnchanged =
+        removedPlugins.empty() &&
+        addedPlugins.empty() &&
+        mConfigurator->getPlugins() == configurator->getPlugins() &&
+        mConfigurator->getPoolPlugins() == configurator->getPoolPlugins();
+
+    /* Card profiles kept as is, and the new or modified ones */
+    std::vector<std::string> keptCardProfileNames;
+    std::vector<std::shared_ptr<CardResourceProfileConfigurator>> addedCardProfiles;
+    for (const auto& profile : configurator->getCardResourceProfileConfigurators()) {
+        bool isKept = false;
+        for (const auto& currentProfile : mConfigurator->getCardResourceProfileConfigurators()) {
+            if (currentProfile->getProfileName() == profile->getProfileName()) {
+                isKept = areEquals(currentProfile, profile) &&
+                         (profile->getPlugins().empty() ?
+                             areGlobalPluginsUnchanged :
+                             std::none_of(profile->getPlugins().begin(),
+                                          profile->getPlugins().end(),
+                                          isPluginRemoved));
+                break;
+            }
+        }
+
+        if (isKept) {
+            keptCardProfileNames.push_back(profile->getProfileName());
+        } else {
+            addedCardProfiles.push_back(profile);
+        }
+    }
+
+    mLogger->info("Keep % card resource profiles, add or replace % card resource profiles, " \
+                  "remove % plugins, add % plugins\n",
+                  keptCardProfileNames.size(),
+                  addedCardProfiles.size(),
+                  removedPlugins.size(),
+                  addedPlugins.size());
+
+    /* Remove the card profiles not kept */
+    std::vector<std::shared_ptr<CardProfileManagerAdapter>> removedCardProfileManagers;
+    std::vector<std::string> removedCardProfileNames;
+    for (auto it = mRegistryUpdate.mCardProfileNameToCardProfileManagerMap.begin();
+         it != mRegistryUpdate.mCardProfileNameToCardProfileManagerMap.end();) {
+        if (std::find(keptCardProfileNames.begin(), keptCardProfileNames.end(), it->first) ==
+                keptCardProfileNames.end()) {
+            mLogger->debug("Remove card resource profile '%'\n", it->first);
+            removedCardProfileManagers.push_back(it->second);
+            removedCardProfileNames.push_back(it->first);
+            it = mRegistryUpdate.mCardProfileNameToCardProfileManagerMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    publishRegistry();
+
+    /* The threads still waiting on the removed card profiles get no card resource */
+    for (const auto& cardProfileManager : removedCardProfileManagers) {
+        cardProfileManager->stop();
+    }
+
+    removeDeferredReaderProbes(removedCardProfileManagers);
+
+    {
+        const std::lock_guard<std::mutex> lock(mCardResourceToCardProfileNamesMutex);
+
+        for (auto it = mCardResourceToCardProfileNamesMap.begin();
+             it != mCardResourceToCardProfileNamesMap.end();) {
+            std::vector<std::string>& names = it->second;
+            for (const auto& removedCardProfileName : removedCardProfileNames) {
+                names.erase(std::remove(names.begin(), names.end(), removedCardProfileName),
+                            names.end());
+            }
+
+            if (names.empty()) {
+                it = mCardResourceToCardProfileNamesMap.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /* Remove the readers of the plugins removed or configured differently */
+    for (const auto& configuredPlugin : removedPlugins) {
+        const auto observable =
+            std::dynamic_pointer_cast<ObservablePlugin>(configuredPlugin->getPlugin());
+        if (configuredPlugin->isWithPluginMonitoring() && observable != nullptr) {
+            mLogger->info("Stop the monitoring of plugin '%'\n",
+                          configuredPlugin->getPlugin()->getName());
+            observable->removeObserver(shared_from_this());
+        }
+
+        std::vector<std::shared_ptr<ReaderManagerAdapter>> readerManagers;
+        for (const auto& pair : mRegistryUpdate.mReaderToReaderManagerMap) {
+            if (pair.second->getPlugin() == configuredPlugin->getPlugin()) {
+                readerManagers.push_back(pair.second);
+            }
+        }
+
+        for (const auto& readerManager : readerManagers) {
+            onCardRemoved(readerManager);
             unregisterReader(readerManager->getReader(), readerManager->getPlugin());
         }
+
+        mPluginToObservableReadersMap.erase(configuredPlugin->getPlugin());
+    }
+
+    publishRegistry();
+
+    std::atomic_store(&mConfigurator, configurator);
+
+    /* Add the new readers and card profiles, the readers in use being probed on their release */
+    const std::vector<std::shared_ptr<ReaderManagerAdapter>> readerManagers =
+        initializeReaderManagers();
+    std::vector<ReaderProbe> readerProbes = initializeCardProfileManagers(addedCardProfiles);
+    probeReaders(readerProbes);
+    completeReaderProbes(readerProbes);
+    removeUnusedReaderManagers();
+
+    /* Start the monitoring of the new plugins and readers if requested */
+    for (const auto& configuredPlugin : addedPlugins) {
+        const auto observable =
+            std::dynamic_pointer_cast<ObservablePlugin>(configuredPlugin->getPlugin());
+        if (configuredPlugin->isWithPluginMonitoring() && observable != nullptr) {
+            mLogger->info("Start the monitoring of plugin '%'\n",
+                          configuredPlugin->getPlugin()->getName());
+            startPluginObservation(configuredPlugin);
+        }
+    }
+
+    for (const auto& readerManager : readerManagers) {
+        if (getReaderManager(readerManager->getReader()) == readerManager) {
+            startMonitoring(readerManager->getReader(), readerManager->getPlugin());
+        }
+    }
+}
+
+bool CardResourceServiceAdapter::haveSameGlobalSettings(
+    const CardResourceServiceConfiguratorAdapter& c1,
+    const CardResourceServiceConfiguratorAdapter& c2)
+{
+    /* Some settings are only set when regular plugins or pool plugins are configured */
+    if (c1.getPlugins().empty() != c2.getPlugins().empty() ||
+        c1.getPoolPlugins().empty() != c2.getPoolPlugins().empty()) {
+        return false;
+    }
+
+    if (!c1.getPlugins().empty() &&
+        (c1.getAllocationStrategy() != c2.getAllocationStrategy() ||
+         c1.getAllocationStrategySpi() != c2.getAllocationStrategySpi() ||
+         c1.getUsageTimeoutMillis() != c2.getUsageTimeoutMillis() ||
+         c1.getUsageTimeoutObserverSpi() != c2.getUsageTimeoutObserverSpi())) {
+        return false;
+    }
+
+    if (!c1.getPoolPlugins().empty() && c1.isUsePoolFirst() != c2.isUsePoolFirst()) {
+        return false;
+    }
+
+    if (c1.isBlockingAllocationMode() != c2.isBlockingAllocationMode()) {
+        return false;
+    }
+
+    return !c1.isBlockingAllocationMode() ||
+           (c1.isFairAllocationMode() == c2.isFairAllocationMode() &&
+            c1.getCycleDurationMillis() == c2.getCycleDurationMillis() &&
+            c1.getTimeoutMillis() == c2.getTimeoutMillis());
+}
+
+bool CardResourceServiceAdapter::containsConfiguredPlugin(
+    const std::vector<std::shared_ptr<ConfiguredPlugin>>& configuredPlugins,
+    const std::shared_ptr<ConfiguredPlugin>& configuredPlugin)
+{
+    for (const auto& other : configuredPlugins) {
+        if (other->getPlugin() == configuredPlugin->getPlugin() &&
+            other->getReaderConfiguratorSpi() == configuredPlugin->getReaderConfiguratorSpi() &&
+            other->isWithPluginMonitoring() == configuredPlugin->isWithPluginMonitoring() &&
+            other->getPluginObservationExceptionHandlerSpi() ==
+                configuredPlugin->getPluginObservationExceptionHandlerSpi() &&
+            other->isWithReaderMonitoring() == configuredPlugin->isWithReaderMonitoring() &&
+            other->getReaderObservationExceptionHandlerSpi() ==
+                configuredPlugin->getReaderObservationExceptionHandlerSpi()) {
+            return true;
+        }
     }
+
+    return false;
+}
+
+bool CardResourceServiceAdapter::areEquals(
+    const std::shared_ptr<CardResourceProfileConfigurator>& p1,
+    const std::shared_ptr<CardResourceProfileConfigurator>& p2)
+{
+    return p1->getProfileName() == p2->getProfileName() &&
+           p1->getCardResourceProfileExtension() == p2->getCardResourceProfileExtension() &&
+           p1->getPlugins() == p2->getPlugins() &&
+           p1->getReaderNameRegex() == p2->getReaderNameRegex() &&
+           p1->getReaderGroupReference() == p2->getReaderGroupReference();
 }
 
 void CardResourceServiceAdapter::unregisterReader(std::shared_ptr<CardReader> reader,
                                                   std::shared_ptr<Plugin> plugin)
 {
-    mReaderToReaderManagerMap.erase(reader);
+    const auto itm = mRegistryUpdate.mReaderToReaderManagerMap.find(reader);
+    if (itm != mRegistryUpdate.mReaderToReaderManagerMap.end()) {
+        const std::lock_guard<std::mutex> lock(mDeferredReaderProbesMutex);
+        mDeferredReaderProbes.erase(itm->second.get());
+        mHasDeferredReaderProbes = !mDeferredReaderProbes.empty();
+
+        /* A resumed probing of the reader only unlocks it */
+        for (auto& readerProbe : mResumedReaderProbes) {
+            if (readerProbe.mReaderManager == itm->second) {
+                readerProbe.mCardProfileManagers.resize(readerProbe.mProbedCount);
+                readerProbe.mCardResourceRanks.resize(readerProbe.mProbedCount);
+            }
+        }
+    }
+
+    mRegistryUpdate.mReaderToReaderManagerMap.erase(reader);
+
+    const auto itr = mRegistryUpdate.mReaderNameToReaderManagerMap.find(reader->getName());
+    if (itr != mRegistryUpdate.mReaderNameToReaderManagerMap.end() &&
+        itr->second->getReader() == reader) {
+        mRegistryUpdate.mReaderNameToReaderManagerMap.erase(itr);
+    }
 
     const auto it = mPluginToObservableReadersMap.find(plugin);
     auto observableCardReader = std::dynamic_pointer_cast<ObservableCardReader>(reader);
@@ -390,6 +1451,12 @@ void CardResourceServiceAdapter::startMonitoring()
             it != mPluginToObservableReadersMap.end()) {
 
             for (auto& reader : it->second) {
+                /* Not yet removed if the readers have been probed in the background */
+                const auto readerManager = getReaderManager(reader);
+                if (readerManager == nullptr || !readerManager->isActive()) {
+                    continue;
+                }
+
                 mLogger->info("Start the monitoring of reader '%'\n", reader->getName());
                 startReaderObservation(reader, configuredPlugin);
             }
@@ -424,10 +1491,10 @@ void CardResourceServiceAdapter::stopMonitoring()
 std::shared_ptr<CardReader> CardResourceServiceAdapter::getReader(const std::string& readerName)
     const
 {
-    for (const auto& pair : mReaderToReaderManagerMap) {
-        if (pair.first->getName() == readerName) {
-            return pair.first;
-        }
+    const std::shared_ptr<const Registry> registry = getRegistry();
+    const auto it = registry->mReaderNameToReaderManagerMap.find(readerName);
+    if (it != registry->mReaderNameToReaderManagerMap.end()) {
+        return it->second->getReader();
     }
 
     return nullptr;
@@ -437,14 +1504,14 @@ void CardResourceServiceAdapter::onReaderConnected(std::shared_ptr<CardReader> r
                                                    std::shared_ptr<Plugin> plugin)
 {
     std::shared_ptr<ReaderManagerAdapter> readerManager = registerReader(reader, plugin);
-    for (auto pair : mCardProfileNameToCardProfileManagerMap) {
-        pair.second->onReaderConnected(readerManager);
-    }
+    publishRegistry();
+    onCardInserted(readerManager);
 
     if (readerManager->isActive()) {
         startMonitoring(reader, plugin);
     } else {
         unregisterReader(reader, plugin);
+        publishRegistry();
     }
 }
 
@@ -486,13 +1553,14 @@ void CardResourceServiceAdapter::startReaderObservation(
 void CardResourceServiceAdapter::onReaderDisconnected(std::shared_ptr<CardReader> reader,
                                                       std::shared_ptr<Plugin> plugin)
 {
-    const auto it = mReaderToReaderManagerMap.find(reader);
-    if (it != mReaderToReaderManagerMap.end()) {
+    const auto it = mRegistryUpdate.mReaderToReaderManagerMap.find(reader);
+    if (it != mRegistryUpdate.mReaderToReaderManagerMap.end()) {
         mLogger->debug("Remove disconnected reader '%' and all associated card resources\n",
                        reader->getName());
 
         onCardRemoved(it->second);
         unregisterReader(reader, plugin);
+        publishRegistry();
     }
 }
 
@@ -518,14 +1586,31 @@ void CardResourceServiceAdapter::onReaderEvent(const std::shared_ptr<CardReaderE
 
 void CardResourceServiceAdapter::onCardInserted(std::shared_ptr<ReaderManagerAdapter> readerManager)
 {
-    for (auto& pair : mCardProfileNameToCardProfileManagerMap) {
-        pair.second->onCardInserted(readerManager);
+    ReaderProbe readerProbe;
+    readerProbe.mReaderManager = readerManager;
+    for (const auto& pair : mRegistryUpdate.mCardProfileNameToCardProfileManagerMap) {
+        if (pair.second->isReaderAccepted(readerManager)) {
+            readerProbe.mCardProfileManagers.push_back(pair.second);
+            readerProbe.mCardResourceRanks.push_back(0);
+        }
+    }
+
+    /* A reader accepted by no card profile is not activated */
+    if (readerProbe.mCardProfileManagers.empty()) {
+        return;
     }
+
+    probeReader(readerProbe, false);
+
+    std::vector<ReaderProbe> readerProbes;
+    readerProbes.push_back(std::move(readerProbe));
+    completeReaderProbes(readerProbes);
 }
 
 void CardResourceServiceAdapter::onCardRemoved(std::shared_ptr<ReaderManagerAdapter> readerManager)
 {
-    const std::vector<std::shared_ptr<CardResource>>& cardResourcesToRemove =
+    /* A copy, each removal updating the card resources of the reader manager */
+    const std::vector<std::shared_ptr<CardResource>> cardResourcesToRemove =
         readerManager->getCardResources();
 
     for (const auto& cardResource : cardResourcesToRemove) {
@@ -12,16 +12,25 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <exception>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 /* Keyple Service Resource */
 #include "CardResource.h"
 #include "CardResourceService.h"
 #include "CardResourceServiceConfiguratorAdapter.h"
 #include "ReaderManagerAdapter.h"
+#include "UsageTimeoutObserverSpi.h"
+#include "UsageTimeoutReaper.h"
 
 /* Keyple Core Service */
 #include "Plugin.h"
@@ -66,6 +75,22 @@ class CardResourceServiceAdapter final
   public CardReaderObserverSpi,
   public std::enable_shared_from_this<CardResourceServiceAdapter> {
 public:
+    /**
+     * (package-private)<br>
+     * Constructor.
+     *
+     * @since 2.0.0
+     */
+    CardResourceServiceAdapter();
+
+    /**
+     * (package-private)<br>
+     * Destructor, waits for the end of the background probing of the readers if any.
+     *
+     * @since 2.1.0
+     */
+    ~CardResourceServiceAdapter();
+
     /**
      * (package-private)<br>
      * Gets the unique instance.
@@ -107,12 +132,94 @@ public:
     void registerPoolCardResource(std::shared_ptr<CardResource> cardResource,
                                   std::shared_ptr<PoolPlugin> poolPlugin);
 
+    /**
+     * (package-private)<br>
+     * Records that a card resource of a "regular" plugin has been added to a card profile, so that
+     * its removal only involves the card profiles referencing it.
+     *
+     * @param cardResource The card resource added.
+     * @param cardResourceProfileName The name of the card profile.
+     * @since 2.1.0
+     */
+    void registerCardResource(std::shared_ptr<CardResource> cardResource,
+                              const std::string& cardResourceProfileName);
+
+    /**
+     * (package-private)<br>
+     * Releases the card resource of a lease, using the reader manager kept by the lease instead of
+     * looking it up.
+     *
+     * <p>The reader is unlocked only if its lock is still the one owned by the lease, the card
+     * resource having possibly been released meanwhile by the expiration of its usage timeout.
+     * Nothing is done if the service has been stopped meanwhile. Errors are logged.
+     *
+     * @param cardResource The card resource to release.
+     * @param readerManager The reader manager of the card resource, null for a pool plugin.
+     * @param lockDeadlineMillis The deadline of the lock owned by the lease, 0 if it has no usage
+     *        timeout.
+     * @since 2.1.0
+     */
+    void releaseLeasedCardResource(const std::shared_ptr<CardResource>& cardResource,
+                                   const std::shared_ptr<ReaderManagerAdapter>& readerManager,
+                                   const uint64_t lockDeadlineMillis);
+
+    /**
+     * (package-private)<br>
+     * Renews the usage timeout of the card resource of a lease, only if the lock of its reader is
+     * still the one owned by the lease.
+     *
+     * @param cardResource The card resource to renew.
+     * @param readerManager The reader manager of the card resource, null for a pool plugin.
+     * @param lockDeadlineMillis The deadline of the lock owned by the lease.
+     * @return The new deadline of the lock owned by the lease.
+     * @throw IllegalStateException If the service is not started or if the usage timeout already
+     *        expired.
+     * @since 2.1.0
+     */
+    uint64_t renewLeasedCardResource(const std::shared_ptr<CardResource>& cardResource,
+                                     const std::shared_ptr<ReaderManagerAdapter>& readerManager,
+                                     const uint64_t lockDeadlineMillis);
+
+    /**
+     * (package-private)<br>
+     * Extends the usage timeout of the card resource of a lease, only if the lock of its reader is
+     * still the one owned by the lease.
+     *
+     * @param cardResource The card resource to extend.
+     * @param readerManager The reader manager of the card resource, null for a pool plugin.
+     * @param lockDeadlineMillis The deadline of the lock owned by the lease.
+     * @param durationMillis The duration to add to the current usage timeout (in milliseconds).
+     * @return The new deadline of the lock owned by the lease.
+     * @throw IllegalArgumentException If the duration is less than 1.
+     * @throw IllegalStateException If the service is not started or if the usage timeout already
+     *        expired.
+     * @since 2.1.0
+     */
+    uint64_t extendLeasedCardResource(const std::shared_ptr<CardResource>& cardResource,
+                                      const std::shared_ptr<ReaderManagerAdapter>& readerManager,
+                                      const uint64_t lockDeadlineMillis,
+                                      const int durationMillis);
+
+    /**
+     * (package-private)<br>
+     * Schedules the automatic release of the provided card resource of a "regular" plugin when its
+     * usage timeout expires, if a usage timeout is configured.
+     *
+     * @param readerManager The reader manager of the locked reader.
+     * @param cardResource The card resource just allocated.
+     * @since 2.1.0
+     */
+    void onReaderLocked(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                        std::shared_ptr<CardResource> cardResource);
+
     /**
      * (package-private)<br>
      * Configures the card resource service.
      *
-     * <p>If service is started, then stops the service, applies the configuration and starts the
-     * service.
+     * <p>If service is started and the global settings (allocation strategy, usage timeout,
+     * allocation mode) are unchanged, then only the plugins, card profiles and readers whose
+     * configuration changed are removed or added, the other card resources remaining available and
+     * allocated. Otherwise, stops the service, applies the configuration and starts the service.
      *
      * <p>If not, then only applies the configuration.
      *
@@ -149,6 +256,46 @@ public:
     std::shared_ptr<CardResource> getCardResource(const std::string& cardResourceProfileName) const
         override;
 
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    void getCardResourceAsync(const std::string& cardResourceProfileName,
+                              std::function<void(std::shared_ptr<CardResource>)> callback) const
+        override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    std::future<std::shared_ptr<CardResource>> getCardResourceAsync(
+        const std::string& cardResourceProfileName) const override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    const std::vector<std::shared_ptr<CardResource>> getCardResources(
+        const std::string& cardResourceProfileName, const int count) override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    const std::vector<std::shared_ptr<CardResource>> getCardResources(
+        const std::vector<std::string>& cardResourceProfileNames) override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    CardResourceLease acquireCardResource(const std::string& cardResourceProfileName) override;
+
     /**
      * {@inheritDoc}
      *
@@ -156,6 +303,28 @@ public:
      */
     void releaseCardResource(std::shared_ptr<CardResource> cardResource) override;
 
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    CardResourceServiceMetrics getMetrics() const override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    void renewCardResource(std::shared_ptr<CardResource> cardResource) override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    void extendCardResource(std::shared_ptr<CardResource> cardResource,
+                            const int durationMillis) override;
+
     /**
      * {@inheritDoc}
      *
@@ -190,53 +359,159 @@ private:
         LoggerFactory::getLogger(typeid(CardResourceServiceAdapter));
 
     /**
-     * Map an accepted reader of a "regular" plugin to a reader manager
+     * (private)<br>
+     * The registered reader managers and card profile managers.
+     *
+     * <p>The maps of the service are only modified by the start, the stop, the configuration and
+     * the plugin and reader events, then published as a new registry which is never modified.
+     * The allocating and releasing threads read the current registry without lock.
+     */
+    struct Registry {
+        /**
+         * Map an accepted reader of a "regular" plugin to a reader manager.<br>
+         * Hashed on the identity of the reader.
+         */
+        std::unordered_map<std::shared_ptr<CardReader>, std::shared_ptr<ReaderManagerAdapter>>
+            mReaderToReaderManagerMap;
+
+        /**
+         * Map the name of an accepted reader of a "regular" plugin to its reader manager.<br>
+         * Index of mReaderToReaderManagerMap kept in sync by registerReader() and
+         * unregisterReader().
+         */
+        std::unordered_map<std::string, std::shared_ptr<ReaderManagerAdapter>>
+            mReaderNameToReaderManagerMap;
+
+        /**
+         * Map a configured card profile name to a card profile manager
+         */
+        std::map<std::string, std::shared_ptr<CardProfileManagerAdapter>>
+            mCardProfileNameToCardProfileManagerMap;
+    };
+
+    /**
+     * The maps being modified, published by publishRegistry()
      */
-    std::map<std::shared_ptr<CardReader>, std::shared_ptr<ReaderManagerAdapter>>
-        mReaderToReaderManagerMap;
+    Registry mRegistryUpdate;
 
     /**
-     * Map a configured card profile name to a card profile manager
+     * The current registry, only accessed through std::atomic_load() and std::atomic_store()
      */
-    std::map<std::string, std::shared_ptr<CardProfileManagerAdapter>>
-        mCardProfileNameToCardProfileManagerMap;
+    std::shared_ptr<const Registry> mRegistry;
+
+    /**
+     * Serializes the publications of the registry and the collection of the metrics, so that a
+     * metrics snapshot is taken on the current registry only
+     */
+    mutable std::mutex mRegistryMutex;
 
     /**
      * Map a card resource to a "pool plugin".<br>
      * A card resource associated to a "pool plugin" is only present in this map for the time of its
-     * use and is not referenced by any card profile manager.
+     * use, leased or not, and is not referenced by any card profile manager. Its size is the
+     * number of pool allocations reported by the metrics.<br>
+     * Hashed on the identity of the card resource.
      */
-    std::map<std::shared_ptr<CardResource>, std::shared_ptr<PoolPlugin>>
+    std::unordered_map<std::shared_ptr<CardResource>, std::shared_ptr<PoolPlugin>>
         mCardResourceToPoolPluginMap;
 
+    /**
+     * Protects mCardResourceToPoolPluginMap, modified by the allocating and releasing threads
+     */
+    mutable std::mutex mCardResourceToPoolPluginMutex;
+
     /**
      * Map a "regular" plugin to its accepted observable readers referenced by at least one card
      * profile manager.<br>
      * This map is useful to observe only the accepted readers in case of a card monitoring request.
+     * <br>
+     * Hashed on the identity of the plugin.
      */
-    std::map<std::shared_ptr<Plugin>, std::vector<std::shared_ptr<ObservableCardReader>>>
+    std::unordered_map<std::shared_ptr<Plugin>, std::vector<std::shared_ptr<ObservableCardReader>>>
         mPluginToObservableReadersMap;
 
     /**
-     * The current configuration
+     * The current configuration.<br>
+     * Replaced through std::atomic_store(), the allocating and releasing threads reading it through
+     * std::atomic_load().
      */
     std::shared_ptr<CardResourceServiceConfiguratorAdapter> mConfigurator;
 
     /**
      * The current status of the card resource service
      */
-    bool mIsStarted;
+    std::atomic<bool> mIsStarted;
+
+    /**
+     * The thread probing the readers in the background after the start of the service, if any
+     */
+    std::thread mReaderProbingThread;
+
+    /**
+     * Requests the probing of the readers to end as soon as possible
+     */
+    std::atomic<bool> mIsReaderProbingCancelled;
+
+    /**
+     * Releases the card resources whose usage timeout expires, if a usage timeout is configured
+     */
+    std::unique_ptr<UsageTimeoutReaper> mUsageTimeoutReaper;
 
     /**
+     * The observer notified when a card resource is released due to its usage timeout, if any
+     */
+    std::shared_ptr<UsageTimeoutObserverSpi> mUsageTimeoutObserverSpi;
+
+    /**
+     * (private)<br>
+     * Gets the card profile manager associated to the provided profile name.
      *
+     * @param cardResourceProfileName The name of the card resource profile.
+     * @return A not null reference.
+     * @throw IllegalArgumentException If the profile name is empty or not configured.
+     * @throw IllegalStateException If the service is not started.
+     */
+    std::shared_ptr<CardProfileManagerAdapter> getCardProfileManager(
+        const std::string& cardResourceProfileName) const;
+
+    /**
+     * Serializes the plugin and reader events and the application of configuration changes
      */
     std::mutex mMutex;
 
     /**
      * (private)<br>
-     * Initializes a reader manager for each reader of each configured "regular" plugin.
+     * Gets the current registry.
+     *
+     * @return A not null reference.
+     */
+    std::shared_ptr<const Registry> getRegistry() const;
+
+    /**
+     * (private)<br>
+     * Publishes a copy of the maps being modified as the current registry.
+     */
+    void publishRegistry();
+
+    /**
+     * Map a card resource of a "regular" plugin to the names of the card profiles referencing it
+     */
+    std::unordered_map<std::shared_ptr<CardResource>, std::vector<std::string>>
+        mCardResourceToCardProfileNamesMap;
+
+    /**
+     * Protects mCardResourceToCardProfileNamesMap, updated by the allocating threads as well
+     */
+    std::mutex mCardResourceToCardProfileNamesMutex;
+
+    /**
+     * (private)<br>
+     * Initializes a reader manager for each reader of each configured "regular" plugin, if not
+     * already registered.
+     *
+     * @return The reader managers created.
      */
-    void initializeReaderManagers();
+    std::vector<std::shared_ptr<ReaderManagerAdapter>> initializeReaderManagers();
 
     /**
      * (private)<br>
@@ -253,18 +528,283 @@ private:
 
     /**
      * (private)<br>
-     * Creates and registers a card profile manager for each configured card profile and creates all
-     * available card resources.
+     * The probing of a reader for all the card profiles accepting it.
+     */
+    struct ReaderProbe {
+        /**
+         * The reader manager to probe
+         */
+        std::shared_ptr<ReaderManagerAdapter> mReaderManager;
+
+        /**
+         * The card profile managers accepting the reader, in the configured order
+         */
+        std::vector<std::shared_ptr<CardProfileManagerAdapter>> mCardProfileManagers;
+
+        /**
+         * The rank of the reader for each card profile manager, in the configured order of its
+         * accepted readers, or 0 to add the card resource after the existing ones
+         */
+        std::vector<uint64_t> mCardResourceRanks;
+
+        /**
+         * The number of card profile managers for which the reader has already been probed
+         */
+        std::size_t mProbedCount = 0;
+
+        /**
+         * The exception raised during the probing, if any
+         */
+        std::exception_ptr mException;
+    };
+
+    /**
+     * The probings postponed because their reader was in use, resumed when the reader is released
+     */
+    std::unordered_map<const ReaderManagerAdapter*, ReaderProbe> mDeferredReaderProbes;
+
+    /**
+     * Protects mDeferredReaderProbes and mResumedReaderProbes, updated by the releasing threads as
+     * well
+     */
+    std::mutex mDeferredReaderProbesMutex;
+
+    /**
+     * Indicates if mDeferredReaderProbes is not empty, checked without locking on each release
+     */
+    std::atomic<bool> mHasDeferredReaderProbes;
+
+    /**
+     * The postponed probings whose reader has been released, still locked until they are resumed
+     */
+    std::deque<ReaderProbe> mResumedReaderProbes;
+
+    /**
+     * Signals a new resumed probing or the end of the service to the resuming thread
+     */
+    std::condition_variable mResumedReaderProbesCondition;
+
+    /**
+     * The thread resuming the postponed probings, started when a first probing is postponed
+     */
+    std::thread mReaderProbeResumingThread;
+
+    /**
+     * Requests the resuming thread to end, no probing being postponed anymore
+     */
+    bool mIsReaderProbeResumingStopped;
+
+    /**
+     * (private)<br>
+     * Creates and registers a card profile manager for each provided card profile and prepares the
+     * probing of the readers they accept.
+     *
+     * @param cardProfiles The card profiles.
+     * @return The readers to probe, each one with the card profile managers accepting it.
+     */
+    std::vector<ReaderProbe> initializeCardProfileManagers(
+        const std::vector<std::shared_ptr<CardResourceProfileConfigurator>>& cardProfiles);
+
+    /**
+     * (private)<br>
+     * Probes the provided readers on a bounded pool of worker threads, the calling thread included.
+     *
+     * <p>Each reader is probed by a single thread, for its card profiles in the configured order.
+     * Each matched card resource is added to its card profile at once, at the rank of the reader,
+     * so that the result does not depend on the order in which the readers are probed.
+     *
+     * <p>The probing ends early if it is cancelled.
+     *
+     * @param readerProbes The readers to probe.
+     */
+    void probeReaders(std::vector<ReaderProbe>& readerProbes) const;
+
+    /**
+     * (private)<br>
+     * Probes the provided readers while the service is already started, then starts the monitoring
+     * under the lock of the events if the probing has not been cancelled in the meantime.
+     *
+     * <p>Probing failures are logged, the card resources of the other readers remain available.
+     *
+     * @param readerProbes The readers to probe.
+     */
+    void probeReadersInBackground(std::vector<ReaderProbe> readerProbes);
+
+    /**
+     * (private)<br>
+     * Logs the failed probings and postpones the ones not completed because their reader is in
+     * use.
+     *
+     * @param readerProbes The probed readers.
+     */
+    void completeReaderProbes(std::vector<ReaderProbe>& readerProbes);
+
+    /**
+     * (private)<br>
+     * Postpones the expiration of the usage timeout of the provided allocated card resource and
+     * reschedules its automatic release.
+     *
+     * @param cardResource The allocated card resource.
+     * @param readerManager The reader manager of the card resource, null for a pool plugin.
+     * @param lockDeadlineMillis The deadline of the lock to extend, 0 for the current lock.
+     * @param durationMillis The duration to add.
+     * @param isFromNow True if the duration is added to the current time rather than to the
+     *        current deadline.
+     * @return The new deadline, 0 if the card resource has no usage timeout.
+     * @throw IllegalStateException If the card resource is not allocated or its usage timeout
+     *        already expired.
+     */
+    uint64_t extendUsageTimeout(std::shared_ptr<CardResource> cardResource,
+                                std::shared_ptr<ReaderManagerAdapter> readerManager,
+                                const uint64_t lockDeadlineMillis,
+                                const int durationMillis,
+                                const bool isFromNow);
+
+    /**
+     * (private)<br>
+     * Gives back the reader of the provided card resource to its pool plugin and wakes up the
+     * threads waiting for a card resource.
+     *
+     * <p>Nothing is done if the card resource does not come from a pool plugin or has already been
+     * released.
+     *
+     * @param cardResource The card resource to release.
      */
-    void initializeCardProfileManagers();
+    void releasePoolCardResource(const std::shared_ptr<CardResource>& cardResource);
+
+    /**
+     * (private)<br>
+     * Frees the provided reader, or resumes its postponed probing if any, and wakes up the threads
+     * waiting for one of its card resources.
+     *
+     * @param readerManager The reader manager of the released reader.
+     */
+    void releaseReader(std::shared_ptr<ReaderManagerAdapter> readerManager);
+
+    /**
+     * (private)<br>
+     * Invoked by the usage timeout reaper when the usage timeout of a card resource expires.<br>
+     * Releases the card resource and notifies the usage timeout observer if it is still allocated
+     * with the same lock.
+     *
+     * @param readerManager The reader manager of the locked reader.
+     * @param cardResource The card resource allocated.
+     * @param deadlineMillis The deadline of the expired lock.
+     */
+    void onUsageTimeout(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                        std::shared_ptr<CardResource> cardResource,
+                        const uint64_t deadlineMillis);
+
+    /**
+     * (private)<br>
+     * Hands the postponed probing of the provided reader, if any, over to the resuming thread
+     * instead of unlocking it. The probing exchanging with the card, the releasing thread does not
+     * wait for it.
+     *
+     * @param readerManager The reader manager of the released reader.
+     * @return False if there is no postponed probing, the reader being still locked.
+     */
+    bool resumeReaderProbe(std::shared_ptr<ReaderManagerAdapter> readerManager);
+
+    /**
+     * (private)<br>
+     * Body of the resuming thread: probes the released readers handed over by resumeReaderProbe()
+     * until the service stops, then makes their card resources available.
+     */
+    void resumeReaderProbes();
+
+    /**
+     * (private)<br>
+     * Stops the resuming thread if any and waits for the end of the ongoing probing. The postponed
+     * probings are forgotten.
+     */
+    void stopReaderProbeResuming();
+
+    /**
+     * (private)<br>
+     * Forgets the postponed probings for the provided card profile managers.
+     *
+     * @param cardProfileManagers The card profile managers removed.
+     */
+    void removeDeferredReaderProbes(
+        const std::vector<std::shared_ptr<CardProfileManagerAdapter>>& cardProfileManagers);
+
+    /**
+     * (private)<br>
+     * Cancels the background probing of the readers if any and waits for its end.
+     */
+    void stopReaderProbing();
+
+    /**
+     * (private)<br>
+     * Probes a reader for the card profiles accepting it not probed yet, and adds each matched card
+     * resource to its card profile.
+     *
+     * <p>The reader is locked before each match, the match unlocking it. The probing stops if the
+     * reader is in use, the card resources already added being available to the allocation.
+     *
+     * @param readerProbe The reader to probe, where to store the progress.
+     * @param isReaderLocked True if the reader is already locked by the caller.
+     */
+    static void probeReader(ReaderProbe& readerProbe, bool isReaderLocked);
 
     /**
      * (private)<br>
      * Removes all reader managers whose reader is not accepted by any card profile manager and
-     * unregisters their associated readers.
+     * unregisters their associated readers, with their card resources.
      */
     void removeUnusedReaderManagers();
 
+    /**
+     * (private)<br>
+     * Applies a new configuration having the same global settings than the current one, without
+     * stopping the service.
+     *
+     * <p>The card profiles removed or configured differently, or using a plugin removed or
+     * configured differently, are removed, as well as the readers of the removed plugins. The new
+     * and modified card profiles are then created and their readers probed, a reader in use being
+     * probed when it is released.
+     *
+     * @param configurator The new configuration.
+     */
+    void applyConfigurationChanges(
+        std::shared_ptr<CardResourceServiceConfiguratorAdapter> configurator);
+
+    /**
+     * (private)<br>
+     * Checks if the provided configurations have the same global settings, i.e. the settings
+     * shared by all the card profiles and readers.
+     *
+     * @param c1 Configuration 1.
+     * @param c2 Configuration 2.
+     * @return True if they have the same global settings.
+     */
+    static bool haveSameGlobalSettings(const CardResourceServiceConfiguratorAdapter& c1,
+                                       const CardResourceServiceConfiguratorAdapter& c2);
+
+    /**
+     * (private)<br>
+     * Checks if the provided collection contains a configured plugin identical to the provided one.
+     *
+     * @param configuredPlugins The collection.
+     * @param configuredPlugin The configured plugin.
+     * @return True if an identical configured plugin is found.
+     */
+    static bool containsConfiguredPlugin(
+        const std::vector<std::shared_ptr<ConfiguredPlugin>>& configuredPlugins,
+        const std::shared_ptr<ConfiguredPlugin>& configuredPlugin);
+
+    /**
+     * (private)<br>
+     * Checks if the provided card profiles are configured identically.
+     *
+     * @param p1 Card profile 1.
+     * @param p2 Card profile 2.
+     * @return True if they are identical.
+     */
+    static bool areEquals(const std::shared_ptr<CardResourceProfileConfigurator>& p1,
+                          const std::shared_ptr<CardResourceProfileConfigurator>& p2);
+
     /**
      * (private)<br>
      * Removes the registered reader manager associated to the provided reader and stops the
@@ -279,7 +819,7 @@ private:
      * (private)<br>
      * Starts the observation of observable plugins and/or observable readers if requested.<br>
      * The observation of the readers is performed only for those accepted by at least one card
-     * profile manager.
+     * profile manager, and already activated.
      */
     void startMonitoring();
 
@@ -301,7 +841,7 @@ private:
     /**
      * (private)<br>
      * Invoked when a new reader is connected.<br>
-     * Notifies all card profile managers about the new available reader.<br>
+     * Probes the new reader as if a card was inserted (see onCardInserted()).<br>
      * If the new reader is accepted by at least one card profile manager, then a new reader manager
      * is registered to the service.
      *
@@ -364,8 +904,12 @@ private:
     /**
      * (private)<br>
      * Invoked when a card is inserted on a reader.<br>
-     * Notifies all card profile managers about the insertion of the card.<br>
-     * Each card profile manager interested by the card reader will try to create a card resource.
+     * Probes the reader for each card profile manager accepting it, as at start (see
+     * probeReader()).
+     *
+     * <p>A card resource of the card may be handed over to a waiting request as soon as it is
+     * added, the probing of the other card profiles being then postponed until the release of the
+     * reader.
      *
      * @param readerManager The associated reader manager.
      */
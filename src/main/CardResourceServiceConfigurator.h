@@ -88,8 +88,12 @@ public:
      * <p>By default, the card resource service is configured with a <b>non-blocking</b> allocation
      * mode.
      *
-     * @param cycleDurationMillis The cycle duration (in milliseconds) is the time between two
-     *        attempts to find an available card.
+     * <p>Waiting threads are woken up as soon as a card resource is released, a card is inserted
+     * or a reader is connected.
+     *
+     * @param cycleDurationMillis The cycle duration (in milliseconds) is the max time between two
+     *        attempts to find an available card when the availability may change without
+     *        notification (pool plugins, usage timeout).
      * @param timeoutMillis The timeout (in milliseconds) is the maximum amount of time the
      *        allocation method will attempt to find an available card.
      * @return The current configurator instance.
@@ -100,12 +104,52 @@ public:
     virtual CardResourceServiceConfigurator& withBlockingAllocationMode(
         const int cycleDurationMillis, const int timeoutMillis) = 0;
 
+    /**
+     * Configures the card resource service to use a blocking allocation mode with the provided
+     * timing parameters used during the allocation process, and optionally a fair allocation.
+     *
+     * <p>In fair mode, the threads waiting for a card resource of a same profile are queued and
+     * each card resource becoming available is directly handed over to the oldest waiting thread.
+     * A new request never overtakes a waiting one.
+     *
+     * @param cycleDurationMillis The cycle duration (in milliseconds) is the max time between two
+     *        attempts to find an available card when the availability may change without
+     *        notification (pool plugins, usage timeout).
+     * @param timeoutMillis The timeout (in milliseconds) is the maximum amount of time the
+     *        allocation method will attempt to find an available card.
+     * @param isFair True to serve the waiting threads in their arrival order.
+     * @return The current configurator instance.
+     * @throw IllegalArgumentException If one of the provided values is less or equal to 0.
+     * @throw IllegalStateException If this step has already been performed.
+     * @since 2.1.0
+     */
+    virtual CardResourceServiceConfigurator& withBlockingAllocationMode(
+        const int cycleDurationMillis, const int timeoutMillis, const bool isFair) = 0;
+
+    /**
+     * Configures the card resource service to probe the readers in the background when it starts.
+     *
+     * <p>By default, the service is available only once all the readers have been probed.<br>
+     * With this option, the service is available as soon as it is started, and each card resource
+     * is added to its card resource profiles as soon as its reader has been probed. The monitoring
+     * of the plugins and readers starts once all the readers have been probed.
+     *
+     * @return The current configurator instance.
+     * @throw IllegalStateException If this step has already been performed.
+     * @since 2.1.0
+     */
+    virtual CardResourceServiceConfigurator& withBackgroundReaderProbing() = 0;
+
     /**
      * Finalizes the configuration of the card resource service.
      *
      * <p>If the service is already started, the new configuration is applied immediately.<br>
      * Any previous configuration will be overwritten.
      *
+     * <p>If the allocation strategy, the usage timeout and the allocation mode are unchanged, then
+     * only the plugins, card resource profiles and readers whose configuration changed are
+     * removed or added. The other card resources remain available, and allocated if they are.
+     *
      * <p>If some global configured plugins are not used by any card resource profile, then they are
      * automatically removed from the configuration.
      *
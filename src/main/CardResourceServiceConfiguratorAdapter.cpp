@@ -30,7 +30,9 @@ using namespace keyple::core::util::cpp;
 using namespace keyple::core::util::cpp::exception;
 
 CardResourceServiceConfiguratorAdapter::CardResourceServiceConfiguratorAdapter()
-: mIsBlockingAllocationMode(false) {}
+: mIsBlockingAllocationMode(false),
+  mIsFairAllocationMode(false),
+  mIsBackgroundReaderProbing(false) {}
 
 CardResourceServiceConfigurator& CardResourceServiceConfiguratorAdapter::withPlugins(
     std::shared_ptr<PluginsConfigurator> pluginsConfigurator)
@@ -45,7 +47,9 @@ CardResourceServiceConfigurator& CardResourceServiceConfiguratorAdapter::withPlu
     mPlugins = pluginsConfigurator->getPlugins();
     mConfiguredPlugins = pluginsConfigurator->getConfiguredPlugins();
     mAllocationStrategy = pluginsConfigurator->getAllocationStrategy();
+    mAllocationStrategySpi = pluginsConfigurator->getAllocationStrategySpi();
     mUsageTimeoutMillis = pluginsConfigurator->getUsageTimeoutMillis();
+    mUsageTimeoutObserverSpi = pluginsConfigurator->getUsageTimeoutObserverSpi();
 
     return *this;
 }
@@ -84,6 +88,12 @@ CardResourceServiceConfigurator& CardResourceServiceConfiguratorAdapter::withCar
 
 CardResourceServiceConfigurator& CardResourceServiceConfiguratorAdapter::withBlockingAllocationMode(
     const int cycleDurationMillis, const int timeoutMillis)
+{
+    return withBlockingAllocationMode(cycleDurationMillis, timeoutMillis, false);
+}
+
+CardResourceServiceConfigurator& CardResourceServiceConfiguratorAdapter::withBlockingAllocationMode(
+    const int cycleDurationMillis, const int timeoutMillis, const bool isFair)
 {
     Assert::getInstance().greaterOrEqual(cycleDurationMillis, 1, "cycleDurationMillis")
                          .greaterOrEqual(timeoutMillis, 1, "timeoutMillis");
@@ -93,12 +103,25 @@ CardResourceServiceConfigurator& CardResourceServiceConfiguratorAdapter::withBlo
     }
 
     mIsBlockingAllocationMode = true;
+    mIsFairAllocationMode = isFair;
     mCycleDurationMillis = cycleDurationMillis;
     mTimeoutMillis = timeoutMillis;
 
     return *this;
 }
 
+CardResourceServiceConfigurator&
+    CardResourceServiceConfiguratorAdapter::withBackgroundReaderProbing()
+{
+    if (mIsBackgroundReaderProbing) {
+        throw IllegalStateException("Background reader probing already configured.");
+    }
+
+    mIsBackgroundReaderProbing = true;
+
+    return *this;
+}
+
 void CardResourceServiceConfiguratorAdapter::configure()
 {
     /*
@@ -198,11 +221,23 @@ AllocationStrategy CardResourceServiceConfiguratorAdapter::getAllocationStrategy
     return mAllocationStrategy;
 }
 
+std::shared_ptr<AllocationStrategySpi>
+    CardResourceServiceConfiguratorAdapter::getAllocationStrategySpi() const
+{
+    return mAllocationStrategySpi;
+}
+
 int CardResourceServiceConfiguratorAdapter::getUsageTimeoutMillis() const
 {
     return mUsageTimeoutMillis;
 }
 
+std::shared_ptr<UsageTimeoutObserverSpi>
+    CardResourceServiceConfiguratorAdapter::getUsageTimeoutObserverSpi() const
+{
+    return mUsageTimeoutObserverSpi;
+}
+
 const std::vector<std::shared_ptr<PoolPlugin>>& CardResourceServiceConfiguratorAdapter::getPoolPlugins()
     const
 {
@@ -225,6 +260,16 @@ bool CardResourceServiceConfiguratorAdapter::isBlockingAllocationMode() const
     return mIsBlockingAllocationMode;
 }
 
+bool CardResourceServiceConfiguratorAdapter::isFairAllocationMode() const
+{
+    return mIsFairAllocationMode;
+}
+
+bool CardResourceServiceConfiguratorAdapter::isBackgroundReaderProbing() const
+{
+    return mIsBackgroundReaderProbing;
+}
+
 int CardResourceServiceConfiguratorAdapter::getCycleDurationMillis() const
 {
     return mCycleDurationMillis;
@@ -85,6 +85,22 @@ public:
     CardResourceServiceConfigurator& withBlockingAllocationMode(const int cycleDurationMillis, 
                                                                 const int timeoutMillis) override;
 
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    CardResourceServiceConfigurator& withBlockingAllocationMode(const int cycleDurationMillis,
+                                                                const int timeoutMillis,
+                                                                const bool isFair) override;
+
+    /**
+     * {@inheritDoc}
+     *
+     * @since 2.1.0
+     */
+    CardResourceServiceConfigurator& withBackgroundReaderProbing() override;
+
     /**
      * {@inheritDoc}
      *
@@ -125,6 +141,14 @@ public:
      */
     AllocationStrategy getAllocationStrategy() const;
 
+    /**
+     * (package-private)<br>
+     *
+     * @return Null if a built-in strategy is used.
+     * @since 2.1.0
+     */
+    std::shared_ptr<AllocationStrategySpi> getAllocationStrategySpi() const;
+
     /**
      * (package-private)<br>
      *
@@ -133,6 +157,14 @@ public:
      */
     int getUsageTimeoutMillis() const;
 
+    /**
+     * (package-private)<br>
+     *
+     * @return Null if no usage timeout observer is set.
+     * @since 2.1.0
+     */
+    std::shared_ptr<UsageTimeoutObserverSpi> getUsageTimeoutObserverSpi() const;
+
     /**
      * (package-private)<br>
      *
@@ -167,6 +199,22 @@ public:
      */
     bool isBlockingAllocationMode() const;
 
+    /**
+     * (package-private)<br>
+     *
+     * @return True if the waiting threads must be served in their arrival order.
+     * @since 2.1.0
+     */
+    bool isFairAllocationMode() const;
+
+    /**
+     * (package-private)<br>
+     *
+     * @return True if the readers must be probed in the background when the service starts.
+     * @since 2.1.0
+     */
+    bool isBackgroundReaderProbing() const;
+
     /**
      * (package-private)<br>
      *
@@ -199,11 +247,21 @@ private:
      */
     AllocationStrategy mAllocationStrategy;
 
+    /**
+     *
+     */
+    std::shared_ptr<AllocationStrategySpi> mAllocationStrategySpi;
+
     /**
      * 
      */
     int mUsageTimeoutMillis;
 
+    /**
+     *
+     */
+    std::shared_ptr<UsageTimeoutObserverSpi> mUsageTimeoutObserverSpi;
+
     /**
      * Pool plugins
      */
@@ -223,6 +281,16 @@ private:
      * Global
      */
     bool mIsBlockingAllocationMode;
+
+    /**
+     *
+     */
+    bool mIsFairAllocationMode;
+
+    /**
+     *
+     */
+    bool mIsBackgroundReaderProbing;
     
     /**
      * 
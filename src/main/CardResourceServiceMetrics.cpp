@@ -0,0 +1,237 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#include "CardResourceServiceMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+/* HISTOGRAM ------------------------------------------------------------------------------------ */
+
+CardResourceServiceMetrics::Histogram::Histogram() : mCount(0), mSumMicros(0), mMaxMicros(0) {}
+
+CardResourceServiceMetrics::Histogram::Histogram(
+    const std::vector<std::pair<uint64_t, uint64_t>>& buckets,
+    const uint64_t sumMicros,
+    const uint64_t maxMicros)
+: mBuckets(buckets), mCount(0), mSumMicros(sumMicros), mMaxMicros(maxMicros)
+{
+    for (const auto& bucket : mBuckets) {
+        mCount += bucket.second;
+    }
+}
+
+uint64_t CardResourceServiceMetrics::Histogram::getCount() const
+{
+    return mCount;
+}
+
+uint64_t CardResourceServiceMetrics::Histogram::getSumMicros() const
+{
+    return mSumMicros;
+}
+
+uint64_t CardResourceServiceMetrics::Histogram::getMaxMicros() const
+{
+    return mMaxMicros;
+}
+
+uint64_t CardResourceServiceMetrics::Histogram::getValueAtPercentile(const double percentile)
+    const
+{
+    if (mCount == 0) {
+        return 0;
+    }
+
+    /* Rank of the value reaching the percentile, the first one at least */
+    const double rank = std::ceil(std::min(std::max(percentile, 0.0), 100.0) * mCount / 100.0);
+    const uint64_t minCount = std::max(static_cast<uint64_t>(rank), static_cast<uint64_t>(1));
+
+    uint64_t count = 0;
+    for (const auto& bucket : mBuckets) {
+        count += bucket.second;
+        if (count >= minCount) {
+            return std::min(bucket.first, mMaxMicros);
+        }
+    }
+
+    return mMaxMicros;
+}
+
+const std::vector<std::pair<uint64_t, uint64_t>>&
+    CardResourceServiceMetrics::Histogram::getBuckets() const
+{
+    return mBuckets;
+}
+
+/* PROFILE METRICS ------------------------------------------------------------------------------ */
+
+CardResourceServiceMetrics::ProfileMetrics::ProfileMetrics(
+    const std::string& profileName,
+    const uint64_t cardResourceCount,
+    const uint64_t freeCardResourceCount,
+    const uint64_t allocationCount,
+    const uint64_t allocationFailureCount,
+    const uint64_t allocationTimeoutCount,
+    const Histogram& acquireWaitTime,
+    const Histogram& poolAllocationTime)
+: mProfileName(profileName),
+  mCardResourceCount(cardResourceCount),
+  mFreeCardResourceCount(freeCardResourceCount),
+  mAllocationCount(allocationCount),
+  mAllocationFailureCount(allocationFailureCount),
+  mAllocationTimeoutCount(allocationTimeoutCount),
+  mAcquireWaitTime(acquireWaitTime),
+  mPoolAllocationTime(poolAllocationTime) {}
+
+const std::string& CardResourceServiceMetrics::ProfileMetrics::getProfileName() const
+{
+    return mProfileName;
+}
+
+uint64_t CardResourceServiceMetrics::ProfileMetrics::getCardResourceCount() const
+{
+    return mCardResourceCount;
+}
+
+uint64_t CardResourceServiceMetrics::ProfileMetrics::getFreeCardResourceCount() const
+{
+    return mFreeCardResourceCount;
+}
+
+uint64_t CardResourceServiceMetrics::ProfileMetrics::getAllocationCount() const
+{
+    return mAllocationCount;
+}
+
+uint64_t CardResourceServiceMetrics::ProfileMetrics::getAllocationFailureCount() const
+{
+    return mAllocationFailureCount;
+}
+
+uint64_t CardResourceServiceMetrics::ProfileMetrics::getAllocationTimeoutCount() const
+{
+    return mAllocationTimeoutCount;
+}
+
+const CardResourceServiceMetrics::Histogram&
+    CardResourceServiceMetrics::ProfileMetrics::getAcquireWaitTime() const
+{
+    return mAcquireWaitTime;
+}
+
+const CardResourceServiceMetrics::Histogram&
+    CardResourceServiceMetrics::ProfileMetrics::getPoolAllocationTime() const
+{
+    return mPoolAllocationTime;
+}
+
+/* READER METRICS ------------------------------------------------------------------------------- */
+
+CardResourceServiceMetrics::ReaderMetrics::ReaderMetrics(const std::string& readerName,
+                                                         const std::string& pluginName,
+                                                         const bool isBusy,
+                                                         const uint64_t lockCount,
+                                                         const uint64_t autoUnlockCount,
+                                                         const uint64_t cumulativeBusyTimeMillis,
+                                                         const Histogram& holdTime,
+                                                         const Histogram& reselectionTime)
+: mReaderName(readerName),
+  mPluginName(pluginName),
+  mIsBusy(isBusy),
+  mLockCount(lockCount),
+  mAutoUnlockCount(autoUnlockCount),
+  mCumulativeBusyTimeMillis(cumulativeBusyTimeMillis),
+  mHoldTime(holdTime),
+  mReselectionTime(reselectionTime) {}
+
+const std::string& CardResourceServiceMetrics::ReaderMetrics::getReaderName() const
+{
+    return mReaderName;
+}
+
+const std::string& CardResourceServiceMetrics::ReaderMetrics::getPluginName() const
+{
+    return mPluginName;
+}
+
+bool CardResourceServiceMetrics::ReaderMetrics::isBusy() const
+{
+    return mIsBusy;
+}
+
+uint64_t CardResourceServiceMetrics::ReaderMetrics::getLockCount() const
+{
+    return mLockCount;
+}
+
+uint64_t CardResourceServiceMetrics::ReaderMetrics::getAutoUnlockCount() const
+{
+    return mAutoUnlockCount;
+}
+
+uint64_t CardResourceServiceMetrics::ReaderMetrics::getCumulativeBusyTimeMillis() const
+{
+    return mCumulativeBusyTimeMillis;
+}
+
+const CardResourceServiceMetrics::Histogram&
+    CardResourceServiceMetrics::ReaderMetrics::getHoldTime() const
+{
+    return mHoldTime;
+}
+
+const CardResourceServiceMetrics::Histogram&
+    CardResourceServiceMetrics::ReaderMetrics::getReselectionTime() const
+{
+    return mReselectionTime;
+}
+
+/* CARD RESOURCE SERVICE METRICS ---------------------------------------------------------------- */
+
+CardResourceServiceMetrics::CardResourceServiceMetrics() : mPoolAllocationCount(0) {}
+
+CardResourceServiceMetrics::CardResourceServiceMetrics(
+    const std::vector<ProfileMetrics>& profileMetrics,
+    const std::vector<ReaderMetrics>& readerMetrics,
+    const uint64_t poolAllocationCount)
+: mProfileMetrics(profileMetrics),
+  mReaderMetrics(readerMetrics),
+  mPoolAllocationCount(poolAllocationCount) {}
+
+const std::vector<CardResourceServiceMetrics::ProfileMetrics>&
+    CardResourceServiceMetrics::getProfileMetrics() const
+{
+    return mProfileMetrics;
+}
+
+const std::vector<CardResourceServiceMetrics::ReaderMetrics>&
+    CardResourceServiceMetrics::getReaderMetrics() const
+{
+    return mReaderMetrics;
+}
+
+uint64_t CardResourceServiceMetrics::getPoolAllocationCount() const
+{
+    return mPoolAllocationCount;
+}
+
+}
+}
+}
+}
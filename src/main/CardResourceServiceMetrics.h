@@ -0,0 +1,478 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Keyple Service Resource */
+#include "KeypleServiceResourceExport.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+/**
+ * Snapshot of the metrics of the card resource service, provided by {@link
+ * CardResourceService::getMetrics()}.
+ *
+ * <p>The counters and histograms are cumulative since the start of the service. The values of a
+ * snapshot are read without stopping the allocations and are therefore not mutually consistent.
+ *
+ * @since 2.1.0
+ */
+class KEYPLESERVICERESOURCE_API CardResourceServiceMetrics final {
+public:
+    /**
+     * Snapshot of a latency histogram.
+     *
+     * <p>The durations are recorded in microseconds into buckets whose width is at most 1/16 of
+     * their lower bound, the precision of a percentile being then about 6%.
+     *
+     * @since 2.1.0
+     */
+    class KEYPLESERVICERESOURCE_API Histogram final {
+    public:
+        /**
+         * Creates an empty histogram.
+         *
+         * @since 2.1.0
+         */
+        Histogram();
+
+        /**
+         * (package-private)<br>
+         * Creates a histogram.
+         *
+         * @param buckets The not empty buckets, as pairs of inclusive upper bound (in
+         *        microseconds) and count, ordered by upper bound.
+         * @param sumMicros The sum of the recorded durations (in microseconds).
+         * @param maxMicros The longest recorded duration (in microseconds).
+         * @since 2.1.0
+         */
+        Histogram(const std::vector<std::pair<uint64_t, uint64_t>>& buckets,
+                  const uint64_t sumMicros,
+                  const uint64_t maxMicros);
+
+        /**
+         * Gets the number of recorded durations.
+         *
+         * @return 0 if no duration has been recorded.
+         * @since 2.1.0
+         */
+        uint64_t getCount() const;
+
+        /**
+         * Gets the sum of the recorded durations.
+         *
+         * @return The sum in microseconds.
+         * @since 2.1.0
+         */
+        uint64_t getSumMicros() const;
+
+        /**
+         * Gets the longest recorded duration.
+         *
+         * @return The duration in microseconds, 0 if no duration has been recorded.
+         * @since 2.1.0
+         */
+        uint64_t getMaxMicros() const;
+
+        /**
+         * Gets the duration below which the provided percentage of the recorded durations are.
+         *
+         * @param percentile The percentage, from 0 to 100.
+         * @return The upper bound of the bucket reaching the percentile, in microseconds, or 0 if
+         *         no duration has been recorded.
+         * @since 2.1.0
+         */
+        uint64_t getValueAtPercentile(const double percentile) const;
+
+        /**
+         * Gets the not empty buckets of the histogram.
+         *
+         * @return Pairs of inclusive upper bound (in microseconds) and count, ordered by upper
+         *         bound.
+         * @since 2.1.0
+         */
+        const std::vector<std::pair<uint64_t, uint64_t>>& getBuckets() const;
+
+    private:
+        /**
+         *
+         */
+        std::vector<std::pair<uint64_t, uint64_t>> mBuckets;
+
+        /**
+         *
+         */
+        uint64_t mCount;
+
+        /**
+         *
+         */
+        uint64_t mSumMicros;
+
+        /**
+         *
+         */
+        uint64_t mMaxMicros;
+    };
+
+    /**
+     * Metrics of a card resource profile.
+     *
+     * @since 2.1.0
+     */
+    class KEYPLESERVICERESOURCE_API ProfileMetrics final {
+    public:
+        /**
+         * (package-private)<br>
+         * Creates the metrics of a card resource profile.
+         *
+         * @param profileName The name of the card resource profile.
+         * @param cardResourceCount The number of card resources of "regular" plugins.
+         * @param freeCardResourceCount The number of card resources not known to be in use.
+         * @param allocationCount The number of card resources allocated.
+         * @param allocationFailureCount The number of requests without card resource available.
+         * @param allocationTimeoutCount The number of requests timed out in blocking mode.
+         * @param acquireWaitTime The durations of the requests.
+         * @param poolAllocationTime The durations of the reader allocations of the pool plugins.
+         * @since 2.1.0
+         */
+        ProfileMetrics(const std::string& profileName,
+                       const uint64_t cardResourceCount,
+                       const uint64_t freeCardResourceCount,
+                       const uint64_t allocationCount,
+                       const uint64_t allocationFailureCount,
+                       const uint64_t allocationTimeoutCount,
+                       const Histogram& acquireWaitTime,
+                       const Histogram& poolAllocationTime);
+
+        /**
+         * Gets the name of the card resource profile.
+         *
+         * @return A not empty string.
+         * @since 2.1.0
+         */
+        const std::string& getProfileName() const;
+
+        /**
+         * Gets the number of card resources of "regular" plugins of the profile.
+         *
+         * @return The number of card resources, allocated or not.
+         * @since 2.1.0
+         */
+        uint64_t getCardResourceCount() const;
+
+        /**
+         * Gets the number of card resources of "regular" plugins of the profile not known to be in
+         * use.
+         *
+         * @return The number of card resources candidate for an allocation.
+         * @since 2.1.0
+         */
+        uint64_t getFreeCardResourceCount() const;
+
+        /**
+         * Gets the number of card resources allocated for the profile, including the batch
+         * allocations.
+         *
+         * @return A cumulative count.
+         * @since 2.1.0
+         */
+        uint64_t getAllocationCount() const;
+
+        /**
+         * Gets the number of requests which ended without card resource in non-blocking mode.
+         *
+         * @return A cumulative count.
+         * @since 2.1.0
+         */
+        uint64_t getAllocationFailureCount() const;
+
+        /**
+         * Gets the number of requests which ended without card resource in blocking mode, after
+         * the timeout.
+         *
+         * @return A cumulative count.
+         * @since 2.1.0
+         */
+        uint64_t getAllocationTimeoutCount() const;
+
+        /**
+         * Gets the durations of the requests, from the request to the allocation of a card
+         * resource or the failure.
+         *
+         * @return A not null reference.
+         * @since 2.1.0
+         */
+        const Histogram& getAcquireWaitTime() const;
+
+        /**
+         * Gets the durations of the reader allocations of the pool plugins.
+         *
+         * @return A not null reference.
+         * @since 2.1.0
+         */
+        const Histogram& getPoolAllocationTime() const;
+
+    private:
+        /**
+         *
+         */
+        std::string mProfileName;
+
+        /**
+         *
+         */
+        uint64_t mCardResourceCount;
+
+        /**
+         *
+         */
+        uint64_t mFreeCardResourceCount;
+
+        /**
+         *
+         */
+        uint64_t mAllocationCount;
+
+        /**
+         *
+         */
+        uint64_t mAllocationFailureCount;
+
+        /**
+         *
+         */
+        uint64_t mAllocationTimeoutCount;
+
+        /**
+         *
+         */
+        Histogram mAcquireWaitTime;
+
+        /**
+         *
+         */
+        Histogram mPoolAllocationTime;
+    };
+
+    /**
+     * Metrics of a reader of a "regular" plugin.
+     *
+     * @since 2.1.0
+     */
+    class KEYPLESERVICERESOURCE_API ReaderMetrics final {
+    public:
+        /**
+         * (package-private)<br>
+         * Creates the metrics of a reader.
+         *
+         * @param readerName The name of the reader.
+         * @param pluginName The name of the plugin of the reader.
+         * @param isBusy True if a card resource of the reader is currently allocated.
+         * @param lockCount The number of allocations of a card resource of the reader.
+         * @param autoUnlockCount The number of card resources released due to the usage timeout.
+         * @param cumulativeBusyTimeMillis The cumulative time during which the reader was busy.
+         * @param holdTime The durations of the allocations.
+         * @param reselectionTime The durations of the card selections made at allocation.
+         * @since 2.1.0
+         */
+        ReaderMetrics(const std::string& readerName,
+                      const std::string& pluginName,
+                      const bool isBusy,
+                      const uint64_t lockCount,
+                      const uint64_t autoUnlockCount,
+                      const uint64_t cumulativeBusyTimeMillis,
+                      const Histogram& holdTime,
+                      const Histogram& reselectionTime);
+
+        /**
+         * Gets the name of the reader.
+         *
+         * @return A not empty string.
+         * @since 2.1.0
+         */
+        const std::string& getReaderName() const;
+
+        /**
+         * Gets the name of the plugin of the reader.
+         *
+         * @return A not empty string.
+         * @since 2.1.0
+         */
+        const std::string& getPluginName() const;
+
+        /**
+         * Indicates if a card resource of the reader is currently allocated.
+         *
+         * @return True if the reader is busy.
+         * @since 2.1.0
+         */
+        bool isBusy() const;
+
+        /**
+         * Gets the number of allocations of a card resource of the reader.
+         *
+         * @return A cumulative count.
+         * @since 2.1.0
+         */
+        uint64_t getLockCount() const;
+
+        /**
+         * Gets the number of card resources of the reader released due to the usage timeout.
+         *
+         * @return A cumulative count.
+         * @since 2.1.0
+         */
+        uint64_t getAutoUnlockCount() const;
+
+        /**
+         * Gets the cumulative time during which the reader was busy.
+         *
+         * @return The duration in milliseconds, not including the current allocation if any.
+         * @since 2.1.0
+         */
+        uint64_t getCumulativeBusyTimeMillis() const;
+
+        /**
+         * Gets the durations of the allocations, from the allocation of a card resource of the
+         * reader to its release.
+         *
+         * @return A not null reference.
+         * @since 2.1.0
+         */
+        const Histogram& getHoldTime() const;
+
+        /**
+         * Gets the durations of the card selections made at allocation, when the card resource was
+         * not the currently selected one.
+         *
+         * @return A not null reference.
+         * @since 2.1.0
+         */
+        const Histogram& getReselectionTime() const;
+
+    private:
+        /**
+         *
+         */
+        std::string mReaderName;
+
+        /**
+         *
+         */
+        std::string mPluginName;
+
+        /**
+         *
+         */
+        bool mIsBusy;
+
+        /**
+         *
+         */
+        uint64_t mLockCount;
+
+        /**
+         *
+         */
+        uint64_t mAutoUnlockCount;
+
+        /**
+         *
+         */
+        uint64_t mCumulativeBusyTimeMillis;
+
+        /**
+         *
+         */
+        Histogram mHoldTime;
+
+        /**
+         *
+         */
+        Histogram mReselectionTime;
+    };
+
+    /**
+     * Creates an empty snapshot.
+     *
+     * @since 2.1.0
+     */
+    CardResourceServiceMetrics();
+
+    /**
+     * (package-private)<br>
+     * Creates a snapshot.
+     *
+     * @param profileMetrics The metrics of the card resource profiles.
+     * @param readerMetrics The metrics of the readers of the "regular" plugins.
+     * @param poolAllocationCount The number of card resources of the "pool" plugins in use.
+     * @since 2.1.0
+     */
+    CardResourceServiceMetrics(const std::vector<ProfileMetrics>& profileMetrics,
+                               const std::vector<ReaderMetrics>& readerMetrics,
+                               const uint64_t poolAllocationCount);
+
+    /**
+     * Gets the metrics of the card resource profiles.
+     *
+     * @return An empty collection if the service is not started.
+     * @since 2.1.0
+     */
+    const std::vector<ProfileMetrics>& getProfileMetrics() const;
+
+    /**
+     * Gets the metrics of the readers of the "regular" plugins.
+     *
+     * @return An empty collection if the service is not started or if there is no reader.
+     * @since 2.1.0
+     */
+    const std::vector<ReaderMetrics>& getReaderMetrics() const;
+
+    /**
+     * Gets the number of card resources allocated from the "pool" plugins and not released yet.
+     *
+     * @return 0 if the service is not started.
+     * @since 2.1.0
+     */
+    uint64_t getPoolAllocationCount() const;
+
+private:
+    /**
+     *
+     */
+    std::vector<ProfileMetrics> mProfileMetrics;
+
+    /**
+     *
+     */
+    std::vector<ReaderMetrics> mReaderMetrics;
+
+    /**
+     *
+     */
+    uint64_t mPoolAllocationCount;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,33 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+/*
+ * Debug logs of the allocation and release paths.
+ *
+ * The arguments are only evaluated when the debug level is enabled, and the logs are compiled out
+ * when KEYPLESERVICERESOURCE_STRIP_DEBUG_LOGS is defined.
+ */
+#if defined(KEYPLESERVICERESOURCE_STRIP_DEBUG_LOGS)
+#define KEYPLESERVICERESOURCE_LOG_DEBUG(logger, ...) \
+    do {                                             \
+    } while (0)
+#else
+#define KEYPLESERVICERESOURCE_LOG_DEBUG(logger, ...) \
+    do {                                             \
+        if ((logger)->isDebugEnabled()) {            \
+            (logger)->debug(__VA_ARGS__);            \
+        }                                            \
+    } while (0)
+#endif
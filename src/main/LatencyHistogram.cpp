@@ -0,0 +1,103 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+const int LatencyHistogram::SUB_BUCKET_BITS = 4;
+const uint64_t LatencyHistogram::SUB_BUCKET_COUNT = static_cast<uint64_t>(1) << SUB_BUCKET_BITS;
+const int LatencyHistogram::MAX_VALUE_BITS = 36;
+
+LatencyHistogram::LatencyHistogram()
+: mBuckets(SUB_BUCKET_COUNT * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1)),
+  mSumMicros(0),
+  mMaxMicros(0)
+{
+    for (auto& bucket : mBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(const std::chrono::steady_clock::duration duration)
+{
+    const int64_t micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    const uint64_t maxValue = (static_cast<uint64_t>(1) << MAX_VALUE_BITS) - 1;
+    const uint64_t value =
+        micros < 0 ? 0 : std::min(static_cast<uint64_t>(micros), maxValue);
+
+    mBuckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    mSumMicros.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t maxMicros = mMaxMicros.load(std::memory_order_relaxed);
+    while (value > maxMicros &&
+           !mMaxMicros.compare_exchange_weak(maxMicros, value, std::memory_order_relaxed)) {
+    }
+}
+
+CardResourceServiceMetrics::Histogram LatencyHistogram::getSnapshot() const
+{
+    std::vector<std::pair<uint64_t, uint64_t>> buckets;
+
+    for (std::size_t i = 0; i < mBuckets.size(); i++) {
+        const uint64_t count = mBuckets[i].load(std::memory_order_relaxed);
+        if (count != 0) {
+            buckets.push_back({getBucketUpperBound(i), count});
+        }
+    }
+
+    return CardResourceServiceMetrics::Histogram(buckets,
+                                                 mSumMicros.load(std::memory_order_relaxed),
+                                                 mMaxMicros.load(std::memory_order_relaxed));
+}
+
+std::size_t LatencyHistogram::getBucketIndex(const uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<std::size_t>(value);
+    }
+
+    int msb = SUB_BUCKET_BITS;
+    while ((value >> (msb + 1)) != 0) {
+        msb++;
+    }
+
+    /* The value is in [2^msb, 2^(msb+1)), split into SUB_BUCKET_COUNT buckets */
+    const int shift = msb - SUB_BUCKET_BITS;
+
+    return static_cast<std::size_t>(SUB_BUCKET_COUNT * (shift + 1) +
+                                    ((value >> shift) - SUB_BUCKET_COUNT));
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(const std::size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    const int shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+    const uint64_t subBucket = SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT;
+
+    return ((subBucket + 1) << shift) - 1;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,121 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/* Keyple Service Resource */
+#include "CardResourceServiceMetrics.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+/**
+ * (package-private)<br>
+ * Lock-free recorder of durations, with a logarithmic precision.
+ *
+ * <p>The durations are counted in microseconds into buckets: the values below 16 have their own
+ * bucket, each following power of two range is split into 16 buckets of equal width. Recording a
+ * duration only involves relaxed atomic increments, so that the allocations are not serialized.
+ *
+ * @since 2.1.0
+ */
+class LatencyHistogram final {
+public:
+    /**
+     * (package-private)<br>
+     * Creates an empty histogram.
+     *
+     * @since 2.1.0
+     */
+    LatencyHistogram();
+
+    /**
+     * (package-private)<br>
+     * Records a duration.<br>
+     * This method is thread-safe and lock-free.
+     *
+     * @param duration The duration, saturated to about 19 hours.
+     * @since 2.1.0
+     */
+    void record(const std::chrono::steady_clock::duration duration);
+
+    /**
+     * (package-private)<br>
+     * Gets a snapshot of the recorded durations.
+     *
+     * @return A new instance.
+     * @since 2.1.0
+     */
+    CardResourceServiceMetrics::Histogram getSnapshot() const;
+
+private:
+    /**
+     * Number of bits of the sub-bucket index within a power of two range
+     */
+    static const int SUB_BUCKET_BITS;
+
+    /**
+     * Number of buckets per power of two range
+     */
+    static const uint64_t SUB_BUCKET_COUNT;
+
+    /**
+     * Number of bits of the largest recordable value
+     */
+    static const int MAX_VALUE_BITS;
+
+    /**
+     * Counts of the recorded durations per bucket
+     */
+    std::vector<std::atomic<uint64_t>> mBuckets;
+
+    /**
+     * Sum of the recorded durations in microseconds
+     */
+    std::atomic<uint64_t> mSumMicros;
+
+    /**
+     * Longest recorded duration in microseconds
+     */
+    std::atomic<uint64_t> mMaxMicros;
+
+    /**
+     * (private)<br>
+     * Gets the index of the bucket of the provided value.
+     *
+     * @param value The value, not greater than the largest recordable value.
+     * @return A valid index.
+     */
+    static std::size_t getBucketIndex(const uint64_t value);
+
+    /**
+     * (private)<br>
+     * Gets the largest value of the provided bucket.
+     *
+     * @param index The index of the bucket.
+     * @return The inclusive upper bound of the bucket.
+     */
+    static uint64_t getBucketUpperBound(const std::size_t index);
+};
+
+}
+}
+}
+}
@@ -0,0 +1,445 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#include "OpenMetricsExporter.h"
+
+#include <cstdio>
+#include <cstring>
+
+/* Keyple Core Util */
+#include "IllegalStateException.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+using namespace keyple::core::util::cpp::exception;
+
+/* WRITER --------------------------------------------------------------------------------------- */
+
+class OpenMetricsExporter::Writer final {
+public:
+    Writer(char* buffer, const std::size_t capacity, std::FILE* file, const bool isOpenMetrics)
+    : mBuffer(buffer),
+      mCapacity(capacity),
+      mFile(file),
+      mIsOpenMetrics(isOpenMetrics),
+      mPosition(0),
+      mLength(0),
+      mHasError(false) {}
+
+    Writer& append(const char c)
+    {
+        if (mPosition == mCapacity && mFile != nullptr) {
+            flush();
+        }
+
+        /* Without file, the characters beyond the capacity are only counted */
+        if (mPosition < mCapacity) {
+            mBuffer[mPosition++] = c;
+        }
+
+        mLength++;
+
+        return *this;
+    }
+
+    Writer& append(const char* text)
+    {
+        while (*text != '\0') {
+            append(*text++);
+        }
+
+        return *this;
+    }
+
+    Writer& appendLabelValue(const std::string& value)
+    {
+        for (const char c : value) {
+            if (c == '\\') {
+                append("\\\\");
+            } else if (c == '"') {
+                append("\\\"");
+            } else if (c == '\n') {
+                append("\\n");
+            } else {
+                append(c);
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * Appends value / 10^scale, without trailing zeros.
+     */
+    Writer& appendDecimal(const uint64_t value, const int scale)
+    {
+        uint64_t divisor = 1;
+        for (int i = 0; i < scale; i++) {
+            divisor *= 10;
+        }
+
+        /* Digits of the integer part, least significant first */
+        char digits[20];
+        int count = 0;
+        uint64_t integer = value / divisor;
+        do {
+            digits[count++] = static_cast<char>('0' + integer % 10);
+            integer /= 10;
+        } while (integer != 0);
+
+        while (count > 0) {
+            append(digits[--count]);
+        }
+
+        uint64_t fraction = value % divisor;
+        if (fraction != 0) {
+            append('.');
+            while (fraction != 0) {
+                divisor /= 10;
+                append(static_cast<char>('0' + fraction / divisor));
+                fraction %= divisor;
+            }
+        }
+
+        return *this;
+    }
+
+    void flush()
+    {
+        if (mPosition != 0 && std::fwrite(mBuffer, 1, mPosition, mFile) != mPosition) {
+            mHasError = true;
+        }
+
+        mPosition = 0;
+    }
+
+    std::size_t getLength() const
+    {
+        return mLength;
+    }
+
+    bool hasError() const
+    {
+        return mHasError;
+    }
+
+    /**
+     * False for the Prometheus text format 0.0.4.
+     */
+    bool isOpenMetrics() const
+    {
+        return mIsOpenMetrics;
+    }
+
+private:
+    char* const mBuffer;
+    const std::size_t mCapacity;
+    std::FILE* const mFile;
+    const bool mIsOpenMetrics;
+    std::size_t mPosition;
+    std::size_t mLength;
+    bool mHasError;
+};
+
+/* OPEN METRICS EXPORTER ------------------------------------------------------------------------ */
+
+const std::vector<uint64_t> OpenMetricsExporter::HISTOGRAM_BOUNDS_MICROS = {
+    100, 250, 500,
+    1000, 2500, 5000,
+    10000, 25000, 50000,
+    100000, 250000, 500000,
+    1000000, 2500000, 5000000,
+    10000000, 30000000, 60000000};
+
+std::size_t OpenMetricsExporter::write(const CardResourceServiceMetrics& metrics,
+                                       char* buffer,
+                                       const std::size_t capacity)
+{
+    Writer writer(buffer, capacity, nullptr, true);
+    render(metrics, writer);
+
+    return writer.getLength();
+}
+
+void OpenMetricsExporter::writeToFile(const CardResourceServiceMetrics& metrics,
+                                      const std::string& path)
+{
+    const std::string temporaryPath = path + ".tmp";
+
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "w");
+    if (file == nullptr) {
+        throw IllegalStateException("Unable to open the file '" + temporaryPath + "'.");
+    }
+
+    /* The text is buffered by the writer only */
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    char buffer[4096];
+    /* The textfile collector of node_exporter does not read the OpenMetrics text format */
+    Writer writer(buffer, sizeof(buffer), file, false);
+    render(metrics, writer);
+    writer.flush();
+
+    const bool isClosed = std::fclose(file) == 0;
+    if (writer.hasError() || !isClosed) {
+        std::remove(temporaryPath.c_str());
+        throw IllegalStateException("Unable to write the file '" + temporaryPath + "'.");
+    }
+
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        throw IllegalStateException("Unable to rename the file '" + temporaryPath + "' to '" +
+                                    path + "'.");
+    }
+}
+
+void OpenMetricsExporter::render(const CardResourceServiceMetrics& metrics, Writer& writer)
+{
+    using ProfileMetrics = CardResourceServiceMetrics::ProfileMetrics;
+    using ReaderMetrics = CardResourceServiceMetrics::ReaderMetrics;
+
+    const std::vector<ReaderMetrics>& readerMetrics = metrics.getReaderMetrics();
+    const std::vector<ProfileMetrics>& profileMetrics = metrics.getProfileMetrics();
+
+    /* Readers */
+    renderFamily("keyple_card_resource_readers",
+                 "gauge",
+                 "Number of readers of the regular plugins.",
+                 writer);
+    writer.append("keyple_card_resource_readers ")
+          .appendDecimal(readerMetrics.size(), 0)
+          .append('\n');
+
+    renderFamily("keyple_card_resource_reader_busy",
+                 "gauge",
+                 "Whether a card resource of the reader is in use.",
+                 writer);
+    for (const auto& reader : readerMetrics) {
+        writer.append("keyple_card_resource_reader_busy");
+        renderLabels(reader, writer);
+        writer.append("} ").append(reader.isBusy() ? '1' : '0').append('\n');
+    }
+
+    renderFamily("keyple_card_resource_reader_locks",
+                 "counter",
+                 "Number of allocations of the card resources of the reader.",
+                 writer);
+    renderSamples("keyple_card_resource_reader_locks_total",
+                  readerMetrics,
+                  &ReaderMetrics::getLockCount,
+                  0,
+                  writer);
+
+    renderFamily("keyple_card_resource_reader_auto_unlocks",
+                 "counter",
+                 "Number of card resources of the reader released due to the usage timeout.",
+                 writer);
+    renderSamples("keyple_card_resource_reader_auto_unlocks_total",
+                  readerMetrics,
+                  &ReaderMetrics::getAutoUnlockCount,
+                  0,
+                  writer);
+
+    renderFamily("keyple_card_resource_reader_busy_seconds",
+                 "counter",
+                 "Cumulative time during which the reader has been in use.",
+                 writer);
+    renderSamples("keyple_card_resource_reader_busy_seconds_total",
+                  readerMetrics,
+                  &ReaderMetrics::getCumulativeBusyTimeMillis,
+                  3,
+                  writer);
+
+    renderHistograms("keyple_card_resource_reader_hold_seconds",
+                     "Durations of use of the card resources of the reader.",
+                     readerMetrics,
+                     &ReaderMetrics::getHoldTime,
+                     writer);
+
+    renderHistograms("keyple_card_resource_reader_reselection_seconds",
+                     "Durations of the card selections made at allocation.",
+                     readerMetrics,
+                     &ReaderMetrics::getReselectionTime,
+                     writer);
+
+    /* Card resource profiles */
+    renderFamily("keyple_card_resource_profile_card_resources",
+                 "gauge",
+                 "Number of card resources of the profile, by state.",
+                 writer);
+    for (const auto& profile : profileMetrics) {
+        const uint64_t count = profile.getCardResourceCount();
+        const uint64_t freeCount = profile.getFreeCardResourceCount();
+
+        writer.append("keyple_card_resource_profile_card_resources");
+        renderLabels(profile, writer);
+        writer.append(",state=\"busy\"} ")
+              .appendDecimal(count > freeCount ? count - freeCount : 0, 0)
+              .append('\n');
+
+        writer.append("keyple_card_resource_profile_card_resources");
+        renderLabels(profile, writer);
+        writer.append(",state=\"free\"} ").appendDecimal(freeCount, 0).append('\n');
+    }
+
+    renderFamily("keyple_card_resource_profile_allocations",
+                 "counter",
+                 "Number of card resources of the profile allocated.",
+                 writer);
+    renderSamples("keyple_card_resource_profile_allocations_total",
+                  profileMetrics,
+                  &ProfileMetrics::getAllocationCount,
+                  0,
+                  writer);
+
+    renderFamily("keyple_card_resource_profile_allocation_failures",
+                 "counter",
+                 "Number of allocation requests of the profile without card resource provided.",
+                 writer);
+    renderSamples("keyple_card_resource_profile_allocation_failures_total",
+                  profileMetrics,
+                  &ProfileMetrics::getAllocationFailureCount,
+                  0,
+                  writer);
+
+    renderFamily("keyple_card_resource_profile_allocation_timeouts",
+                 "counter",
+                 "Number of blocking allocation requests of the profile which timed out.",
+                 writer);
+    renderSamples("keyple_card_resource_profile_allocation_timeouts_total",
+                  profileMetrics,
+                  &ProfileMetrics::getAllocationTimeoutCount,
+                  0,
+                  writer);
+
+    renderHistograms("keyple_card_resource_profile_acquire_wait_seconds",
+                     "Durations of the allocation requests of the profile.",
+                     profileMetrics,
+                     &ProfileMetrics::getAcquireWaitTime,
+                     writer);
+
+    renderHistograms("keyple_card_resource_profile_pool_allocation_seconds",
+                     "Durations of the allocations of the pool plugin readers.",
+                     profileMetrics,
+                     &ProfileMetrics::getPoolAllocationTime,
+                     writer);
+
+    /* Pool plugins */
+    renderFamily("keyple_card_resource_pool_allocations",
+                 "gauge",
+                 "Number of card resources of the pool plugins in use.",
+                 writer);
+    writer.append("keyple_card_resource_pool_allocations ")
+          .appendDecimal(metrics.getPoolAllocationCount(), 0)
+          .append('\n');
+
+    if (writer.isOpenMetrics()) {
+        writer.append("# EOF\n");
+    }
+}
+
+void OpenMetricsExporter::renderFamily(const char* name,
+                                       const char* type,
+                                       const char* help,
+                                       Writer& writer)
+{
+    /* The Prometheus text format has no family distinct from the "_total" samples */
+    const char* suffix =
+        !writer.isOpenMetrics() && std::strcmp(type, "counter") == 0 ? "_total" : "";
+
+    writer.append("# TYPE ").append(name).append(suffix).append(' ').append(type).append('\n');
+    writer.append("# HELP ").append(name).append(suffix).append(' ').append(help).append('\n');
+}
+
+void OpenMetricsExporter::renderLabels(
+    const CardResourceServiceMetrics::ProfileMetrics& profileMetrics, Writer& writer)
+{
+    writer.append("{profile=\"").appendLabelValue(profileMetrics.getProfileName()).append('"');
+}
+
+void OpenMetricsExporter::renderLabels(
+    const CardResourceServiceMetrics::ReaderMetrics& readerMetrics, Writer& writer)
+{
+    writer.append("{plugin=\"").appendLabelValue(readerMetrics.getPluginName())
+          .append("\",reader=\"").appendLabelValue(readerMetrics.getReaderName()).append('"');
+}
+
+template <typename T>
+void OpenMetricsExporter::renderSamples(const char* name,
+                                        const std::vector<T>& elements,
+                                        uint64_t (T::*getter)() const,
+                                        const int scale,
+                                        Writer& writer)
+{
+    for (const auto& element : elements) {
+        writer.append(name);
+        renderLabels(element, writer);
+        writer.append("} ").appendDecimal((element.*getter)(), scale).append('\n');
+    }
+}
+
+template <typename T>
+void OpenMetricsExporter::renderHistograms(
+    const char* name,
+    const char* help,
+    const std::vector<T>& elements,
+    const CardResourceServiceMetrics::Histogram& (T::*getter)() const,
+    Writer& writer)
+{
+    renderFamily(name, "histogram", help, writer);
+
+    for (const auto& element : elements) {
+        const CardResourceServiceMetrics::Histogram& histogram = (element.*getter)();
+        const std::vector<std::pair<uint64_t, uint64_t>>& buckets = histogram.getBuckets();
+
+        /*
+         * The buckets of the snapshot are sorted by upper bound, each one being counted in the
+         * first exposed bucket containing its upper bound (cumulative counts).
+         */
+        auto it = buckets.begin();
+        uint64_t cumulativeCount = 0;
+
+        for (const uint64_t bound : HISTOGRAM_BOUNDS_MICROS) {
+            while (it != buckets.end() && it->first <= bound) {
+                cumulativeCount += it->second;
+                ++it;
+            }
+
+            writer.append(name).append("_bucket");
+            renderLabels(element, writer);
+            writer.append(",le=\"").appendDecimal(bound, 6).append("\"} ")
+                  .appendDecimal(cumulativeCount, 0)
+                  .append('\n');
+        }
+
+        writer.append(name).append("_bucket");
+        renderLabels(element, writer);
+        writer.append(",le=\"+Inf\"} ").appendDecimal(histogram.getCount(), 0).append('\n');
+
+        writer.append(name).append("_count");
+        renderLabels(element, writer);
+        writer.append("} ").appendDecimal(histogram.getCount(), 0).append('\n');
+
+        writer.append(name).append("_sum");
+        renderLabels(element, writer);
+        writer.append("} ").appendDecimal(histogram.getSumMicros(), 6).append('\n');
+    }
+}
+
+}
+}
+}
+}
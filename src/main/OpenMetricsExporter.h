@@ -0,0 +1,199 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Keyple Service Resource */
+#include "CardResourceServiceMetrics.h"
+#include "KeypleServiceResourceExport.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+/**
+ * Renders a {@link CardResourceServiceMetrics} snapshot in the OpenMetrics text format, to be
+ * scraped by Prometheus.
+ *
+ * <p>The text can be written into a caller-provided buffer, for example to be served by an
+ * embedded HTTP endpoint, or into a file read by the textfile collector of node_exporter. As this
+ * collector only reads the Prometheus text format 0.0.4, the file is written in this format, which
+ * differs only by the metadata of the counters, named after their "_total" samples, and by the
+ * absence of the final "# EOF" line.
+ *
+ * <p>The rendering formats the values incrementally into the destination and does not allocate
+ * any memory. Taking the snapshot with {@link CardResourceService::getMetrics()} is the only step
+ * interacting with the service, so that a scrape never delays the allocations.
+ *
+ * <p>The exposed metric families, all prefixed by <code>keyple_card_resource_</code>, are:
+ *
+ * <ul>
+ *   <li><code>readers</code>: number of readers of the "regular" plugins.
+ *   <li><code>reader_busy</code>, <code>reader_locks</code>, <code>reader_auto_unlocks</code>,
+ *       <code>reader_busy_seconds</code>, <code>reader_hold_seconds</code> and
+ *       <code>reader_reselection_seconds</code>: per reader, labelled by <code>plugin</code> and
+ *       <code>reader</code>.
+ *   <li><code>profile_card_resources</code> (labelled by <code>state</code>, "busy" or "free"),
+ *       <code>profile_allocations</code>, <code>profile_allocation_failures</code>,
+ *       <code>profile_allocation_timeouts</code>, <code>profile_acquire_wait_seconds</code> and
+ *       <code>profile_pool_allocation_seconds</code>: per card resource profile, labelled by
+ *       <code>profile</code>.
+ *   <li><code>pool_allocations</code>: number of card resources of the "pool" plugins in use.
+ * </ul>
+ *
+ * @since 2.1.0
+ */
+class KEYPLESERVICERESOURCE_API OpenMetricsExporter final {
+public:
+    /**
+     * Writes the metrics into the provided buffer, in the OpenMetrics text format.
+     *
+     * <p>The text is not null-terminated. If the buffer is too small, then only its first
+     * <code>capacity</code> characters are written and the returned length can be used to retry
+     * with a large enough buffer.
+     *
+     * @param metrics The metrics to render.
+     * @param buffer The destination buffer, may be null if the capacity is 0.
+     * @param capacity The size of the buffer.
+     * @return The length of the full text.
+     * @since 2.1.0
+     */
+    static std::size_t write(const CardResourceServiceMetrics& metrics,
+                             char* buffer,
+                             const std::size_t capacity);
+
+    /**
+     * Writes the metrics into the provided file, in the Prometheus text format 0.0.4 read by the
+     * textfile collector of node_exporter.
+     *
+     * <p>The text is first written into a temporary file named after the provided one with a
+     * ".tmp" suffix, which is then renamed, so that a collector never reads a partial file.
+     *
+     * @param metrics The metrics to render.
+     * @param path The path of the file, usually with a ".prom" extension.
+     * @throw IllegalStateException If the file cannot be written.
+     * @since 2.1.0
+     */
+    static void writeToFile(const CardResourceServiceMetrics& metrics, const std::string& path);
+
+private:
+    /**
+     * (private)<br>
+     * Destination of the rendered text, a fixed size buffer which is either flushed into a file
+     * when full or truncated.
+     */
+    class Writer;
+
+    /**
+     * Upper bounds of the buckets of the exposed histograms, in microseconds
+     */
+    static const std::vector<uint64_t> HISTOGRAM_BOUNDS_MICROS;
+
+    /**
+     * Private constructor
+     */
+    OpenMetricsExporter();
+
+    /**
+     * (private)<br>
+     * Renders all the metric families.
+     *
+     * @param metrics The metrics to render.
+     * @param writer The destination.
+     */
+    static void render(const CardResourceServiceMetrics& metrics, Writer& writer);
+
+    /**
+     * (private)<br>
+     * Renders the metadata of a metric family, named after its samples for a counter in the
+     * Prometheus text format.
+     *
+     * @param name The name of the family.
+     * @param type The OpenMetrics type of the family.
+     * @param help The description of the family.
+     * @param writer The destination.
+     */
+    static void renderFamily(const char* name,
+                             const char* type,
+                             const char* help,
+                             Writer& writer);
+
+    /**
+     * (private)<br>
+     * Renders the labels identifying the provided card resource profile, without the closing
+     * brace.
+     *
+     * @param profileMetrics The metrics of the profile.
+     * @param writer The destination.
+     */
+    static void renderLabels(const CardResourceServiceMetrics::ProfileMetrics& profileMetrics,
+                             Writer& writer);
+
+    /**
+     * (private)<br>
+     * Renders the labels identifying the provided reader, without the closing brace.
+     *
+     * @param readerMetrics The metrics of the reader.
+     * @param writer The destination.
+     */
+    static void renderLabels(const CardResourceServiceMetrics::ReaderMetrics& readerMetrics,
+                             Writer& writer);
+
+    /**
+     * (private)<br>
+     * Renders a sample of a counter or a gauge for each provided element.
+     *
+     * @param name The name of the sample.
+     * @param elements The profiles or readers metrics.
+     * @param getter The getter of the value.
+     * @param scale The number of decimal digits of the value, 3 for a value in milliseconds to
+     *        render in seconds.
+     * @param writer The destination.
+     */
+    template <typename T>
+    static void renderSamples(const char* name,
+                              const std::vector<T>& elements,
+                              uint64_t (T::*getter)() const,
+                              const int scale,
+                              Writer& writer);
+
+    /**
+     * (private)<br>
+     * Renders the samples of a histogram for each provided element, the buckets of the snapshot
+     * being merged into the buckets delimited by HISTOGRAM_BOUNDS_MICROS.
+     *
+     * @param name The name of the family.
+     * @param help The description of the family.
+     * @param elements The profiles or readers metrics.
+     * @param getter The getter of the histogram.
+     * @param writer The destination.
+     */
+    template <typename T>
+    static void renderHistograms(
+        const char* name,
+        const char* help,
+        const std::vector<T>& elements,
+        const CardResourceServiceMetrics::Histogram& (T::*getter)() const,
+        Writer& writer);
+};
+
+}
+}
+}
+}
@@ -38,9 +38,11 @@ using ConfiguredPlugin = PluginsConfigurator::ConfiguredPlugin;
 
 PluginsConfigurator::Builder::Builder()
 : mAllocationStrategy(AllocationStrategy::FIRST),
-  mAllocationStrategyConfigured(false), 
+  mAllocationStrategySpi(nullptr),
+  mAllocationStrategyConfigured(false),
   mUsageTimeoutMillis(0),
-  mUsageTimeoutMillisConfigured(false) {}
+  mUsageTimeoutMillisConfigured(false),
+  mUsageTimeoutObserverSpi(nullptr) {}
 
 PluginsConfigurator::Builder& PluginsConfigurator::Builder::withAllocationStrategy(
     const AllocationStrategy allocationStrategy)
@@ -55,6 +57,21 @@ PluginsConfigurator::Builder& PluginsConfigurator::Builder::withAllocationStrate
     return *this;
 }
 
+PluginsConfigurator::Builder& PluginsConfigurator::Builder::withAllocationStrategy(
+    std::shared_ptr<AllocationStrategySpi> allocationStrategySpi)
+{
+    Assert::getInstance().notNull(allocationStrategySpi, "allocationStrategySpi");
+
+    if (mAllocationStrategyConfigured == true) {
+        throw IllegalStateException("Allocation strategy already configured.");
+    }
+
+    mAllocationStrategySpi = allocationStrategySpi;
+    mAllocationStrategyConfigured = true;
+
+    return *this;
+}
+
 PluginsConfigurator::Builder& PluginsConfigurator::Builder::withUsageTimeout(
     const int usageTimeoutMillis)
 {
@@ -70,6 +87,17 @@ PluginsConfigurator::Builder& PluginsConfigurator::Builder::withUsageTimeout(
     return *this;
 }
 
+PluginsConfigurator::Builder& PluginsConfigurator::Builder::withUsageTimeout(
+    const int usageTimeoutMillis, std::shared_ptr<UsageTimeoutObserverSpi> usageTimeoutObserverSpi)
+{
+    Assert::getInstance().notNull(usageTimeoutObserverSpi, "usageTimeoutObserverSpi");
+
+    withUsageTimeout(usageTimeoutMillis);
+    mUsageTimeoutObserverSpi = usageTimeoutObserverSpi;
+
+    return *this;
+}
+
 PluginsConfigurator::Builder& PluginsConfigurator::Builder::addPlugin(
     std::shared_ptr<Plugin> plugin, std::shared_ptr<ReaderConfiguratorSpi> readerConfiguratorSpi)
 {
@@ -189,11 +217,21 @@ AllocationStrategy PluginsConfigurator::getAllocationStrategy() const
     return mAllocationStrategy;
 }
 
+std::shared_ptr<AllocationStrategySpi> PluginsConfigurator::getAllocationStrategySpi() const
+{
+    return mAllocationStrategySpi;
+}
+
 int PluginsConfigurator::getUsageTimeoutMillis() const
 {
     return mUsageTimeoutMillis;
 }
 
+std::shared_ptr<UsageTimeoutObserverSpi> PluginsConfigurator::getUsageTimeoutObserverSpi() const
+{
+    return mUsageTimeoutObserverSpi;
+}
+
 const std::vector<std::shared_ptr<Plugin>>& PluginsConfigurator::getPlugins() const
 {
     return mPlugins;
@@ -212,7 +250,9 @@ PluginsConfigurator::Builder* PluginsConfigurator::builder()
 
 PluginsConfigurator::PluginsConfigurator(PluginsConfigurator::Builder* builder)
 : mAllocationStrategy(builder->mAllocationStrategy),
+  mAllocationStrategySpi(builder->mAllocationStrategySpi),
   mUsageTimeoutMillis(builder->mUsageTimeoutMillis),
+  mUsageTimeoutObserverSpi(builder->mUsageTimeoutObserverSpi),
   mPlugins(builder->mPlugins),
   mConfiguredPlugins(builder->mConfiguredPlugins)
 {
@@ -23,8 +23,10 @@
 #include "PluginObservationExceptionHandlerSpi.h"
 
 /* Keyple Service Resource */
+#include "AllocationStrategySpi.h"
 #include "KeypleServiceResourceExport.h"
 #include "ReaderConfiguratorSpi.h"
+#include "UsageTimeoutObserverSpi.h"
 
 namespace keyple {
 namespace core {
@@ -71,7 +73,23 @@ public:
          *
          * @since 2.0.0
          */
-        RANDOM
+        RANDOM,
+
+        /**
+         * Configures the card resource service to provide the available card whose reader has been
+         * idle for the longest time.
+         *
+         * @since 2.1.0
+         */
+        LEAST_RECENTLY_USED,
+
+        /**
+         * Configures the card resource service to provide the available card whose reader has the
+         * lowest cumulative busy time, to balance the usage of the cards.
+         *
+         * @since 2.1.0
+         */
+        LEAST_LOADED
     };
 
     /**
@@ -211,10 +229,27 @@ public:
          */
         Builder& withAllocationStrategy(const AllocationStrategy allocationStrategy);
 
+        /**
+         * Specifies a custom allocation strategy to perform when a card resource is requested.
+         *
+         * <p>Default value: AllocationStrategy::FIRST
+         *
+         * @param allocationStrategySpi The custom allocation strategy to use.
+         * @return The current builder instance.
+         * @throw IllegalArgumentException If the provided strategy is null.
+         * @throw IllegalStateException If the strategy has already been configured.
+         * @since 2.1.0
+         */
+        Builder& withAllocationStrategy(
+            std::shared_ptr<AllocationStrategySpi> allocationStrategySpi);
+
         /**
          * Specifies the timeout to use after that an allocated card resource can be automatically
          * reallocated by card resource service to a new thread if requested.
          *
+         * <p>The card resources are released as soon as their usage timeout expires, the threads
+         * waiting for a card resource being then woken up.
+         *
          * <p>Default value: infinite
          *
          * @param usageTimeoutMillis The max usage duration of a card resource (in milliseconds).
@@ -225,6 +260,21 @@ public:
          */
         Builder& withUsageTimeout(const int usageTimeoutMillis);
 
+        /**
+         * Specifies the timeout to use after that an allocated card resource is automatically
+         * released by card resource service, and an observer notified of each automatic release.
+         *
+         * @param usageTimeoutMillis The max usage duration of a card resource (in milliseconds).
+         * @param usageTimeoutObserverSpi The observer of the automatic releases.
+         * @return The current builder instance.
+         * @throw IllegalArgumentException If the provided value is less or equal to 0 or if the
+         *        observer is null.
+         * @throw IllegalStateException If the timeout has already been configured.
+         * @since 2.1.0
+         */
+        Builder& withUsageTimeout(const int usageTimeoutMillis,
+                                  std::shared_ptr<UsageTimeoutObserverSpi> usageTimeoutObserverSpi);
+
         /**
          * Adds a {@link Plugin} or {@link ObservablePlugin} to the default list of all card
          * profiles.
@@ -293,6 +343,11 @@ public:
          */
         AllocationStrategy mAllocationStrategy;
 
+        /**
+         *
+         */
+        std::shared_ptr<AllocationStrategySpi> mAllocationStrategySpi;
+
         /**
          * C++: addon
          */
@@ -308,6 +363,11 @@ public:
          */
         bool mUsageTimeoutMillisConfigured;
 
+        /**
+         *
+         */
+        std::shared_ptr<UsageTimeoutObserverSpi> mUsageTimeoutObserverSpi;
+
         /**
          *
          */
@@ -333,6 +393,15 @@ public:
      */
     AllocationStrategy getAllocationStrategy() const;
 
+    /**
+     * (package-private)<br>
+     * Gets the custom card resource allocation strategy.
+     *
+     * @return Null if a built-in strategy is used.
+     * @since 2.1.0
+     */
+    std::shared_ptr<AllocationStrategySpi> getAllocationStrategySpi() const;
+
     /**
      * (package-private)<br>
      * Gets the configured usage timeout.
@@ -342,6 +411,15 @@ public:
      */
     int getUsageTimeoutMillis() const;
 
+    /**
+     * (package-private)<br>
+     * Gets the observer of the automatic releases due to the usage timeout.
+     *
+     * @return Null if no observer is set.
+     * @since 2.1.0
+     */
+    std::shared_ptr<UsageTimeoutObserverSpi> getUsageTimeoutObserverSpi() const;
+
     /**
      * (package-private)<br>
      * Gets the list of all configured "regular" plugins.
@@ -379,11 +457,21 @@ private:
      */
     const AllocationStrategy mAllocationStrategy;
 
+    /**
+     *
+     */
+    const std::shared_ptr<AllocationStrategySpi> mAllocationStrategySpi;
+
     /**
      *
      */
     const int mUsageTimeoutMillis;
 
+    /**
+     *
+     */
+    const std::shared_ptr<UsageTimeoutObserverSpi> mUsageTimeoutObserverSpi;
+
     /**
      *
      */
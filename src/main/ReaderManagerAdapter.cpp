@@ -12,10 +12,11 @@
 
 #include "ReaderManagerAdapter.h"
 
+#include <limits>
+
 /* Keyple Core Util */
 #include "Arrays.h"
 #include "IllegalStateException.h"
-#include "System.h"
 
 /* Keyple Core Service */
 #include "SmartCardServiceProvider.h"
@@ -29,6 +30,9 @@ using namespace keyple::core::service;
 using namespace keyple::core::util::cpp;
 using namespace keyple::core::util::cpp::exception;
 
+const uint64_t ReaderManagerAdapter::UNLOCKED = 0;
+const uint64_t ReaderManagerAdapter::LOCKED_WITHOUT_TIMEOUT = std::numeric_limits<uint64_t>::max();
+
 ReaderManagerAdapter::ReaderManagerAdapter(
    std::shared_ptr<CardReader> reader,
    std::shared_ptr<Plugin> plugin,
@@ -38,8 +42,14 @@ ReaderManagerAdapter::ReaderManagerAdapter(
   mPlugin(plugin),
   mReaderConfiguratorSpi(readerConfiguratorSpi),
   mUsageTimeoutMillis(usageTimeoutMillis),
+  mLockState(UNLOCKED),
+  mLockTimeMillis(0),
+  mLastUnlockTimeMillis(0),
+  mCumulativeBusyTimeMillis(0),
+  mLockCount(0),
+  mAutoUnlockCount(0),
+  mHoldStartTime(0),
   mSelectedCardResource(nullptr),
-  mIsBusy(false),
   mIsActive(false) {}
 
 std::shared_ptr<CardReader> ReaderManagerAdapter::getReader() const
@@ -52,11 +62,104 @@ std::shared_ptr<Plugin> ReaderManagerAdapter::getPlugin() const
     return mPlugin;
 }
 
-const std::vector<std::shared_ptr<CardResource>>& ReaderManagerAdapter::getCardResources() const
+const std::vector<std::shared_ptr<CardResource>> ReaderManagerAdapter::getCardResources() const
 {
+    const std::lock_guard<std::mutex> lock(mCardResourcesMutex);
+
     return mCardResources;
 }
 
+uint64_t ReaderManagerAdapter::getLastUnlockTimeMillis() const
+{
+    return mLastUnlockTimeMillis;
+}
+
+uint64_t ReaderManagerAdapter::getCumulativeBusyTimeMillis() const
+{
+    return mCumulativeBusyTimeMillis;
+}
+
+CardResourceServiceMetrics::ReaderMetrics ReaderManagerAdapter::getMetrics() const
+{
+    return CardResourceServiceMetrics::ReaderMetrics(mReader->getName(),
+                                                     mPlugin->getName(),
+                                                     mLockState != UNLOCKED,
+                                                     mLockCount,
+                                                     mAutoUnlockCount,
+                                                     mCumulativeBusyTimeMillis,
+                                                     mHoldTimeHistogram.getSnapshot(),
+                                                     mReselectionTimeHistogram.getSnapshot());
+}
+
+uint64_t ReaderManagerAdapter::getCurrentTimeMillis()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t ReaderManagerAdapter::getLockDeadlineMillis() const
+{
+    const uint64_t lockState = mLockState;
+
+    return lockState != LOCKED_WITHOUT_TIMEOUT ? lockState : UNLOCKED;
+}
+
+bool ReaderManagerAdapter::expireLock(const uint64_t deadlineMillis)
+{
+    if (deadlineMillis == UNLOCKED || !takeOverLock(deadlineMillis)) {
+        return false;
+    }
+
+    mAutoUnlockCount++;
+
+    mLogger->warn("Reader '%' automatically unlocked due to a usage duration over than % " \
+                  "milliseconds\n",
+                  mReader->getName(),
+                  mUsageTimeoutMillis);
+
+    return true;
+}
+
+bool ReaderManagerAdapter::takeOverLock(const uint64_t lockDeadlineMillis)
+{
+    /* The deadline is cleared so that a concurrent expiration or extension fails */
+    uint64_t lockState = lockDeadlineMillis != UNLOCKED ? lockDeadlineMillis
+                                                        : LOCKED_WITHOUT_TIMEOUT;
+
+    return lockDeadlineMillis != LOCKED_WITHOUT_TIMEOUT &&
+           mLockState.compare_exchange_strong(lockState, LOCKED_WITHOUT_TIMEOUT);
+}
+
+uint64_t ReaderManagerAdapter::extendLock(const uint64_t lockDeadlineMillis,
+                                          const uint64_t durationMillis,
+                                          const bool isFromNow)
+{
+    const uint64_t now = getCurrentTimeMillis();
+
+    uint64_t lockState = mLockState.load();
+    uint64_t newLockState;
+    do {
+        /* An expired lock may be taken over at any time */
+        if (lockState == UNLOCKED || (mUsageTimeoutMillis > 0 && lockState <= now)) {
+            return UNLOCKED;
+        }
+
+        /* The reader may have been released and locked again by another user */
+        if (lockDeadlineMillis != UNLOCKED && lockState != lockDeadlineMillis) {
+            return UNLOCKED;
+        }
+
+        /* The state of an expiring lock, or of any lock when there is no usage timeout */
+        if (lockState == LOCKED_WITHOUT_TIMEOUT) {
+            return mUsageTimeoutMillis > 0 ? UNLOCKED : LOCKED_WITHOUT_TIMEOUT;
+        }
+
+        newLockState = (isFromNow ? now : lockState) + durationMillis;
+    } while (!mLockState.compare_exchange_weak(lockState, newLockState));
+
+    return newLockState;
+}
+
 bool ReaderManagerAdapter::isActive() const
 {
     return mIsActive;
@@ -75,13 +178,18 @@ std::shared_ptr<CardResource> ReaderManagerAdapter::matches(
     std::shared_ptr<CardResourceProfileExtension> extension)
 {
     std::shared_ptr<CardResource> cardResource = nullptr;
-    std::shared_ptr<SmartCard> smartCard =
-        extension->matches(mReader,
-                           SmartCardServiceProvider::getService()->createCardSelectionManager());
+    std::shared_ptr<SmartCard> smartCard = nullptr;
+    try {
+        smartCard = extension->matches(mReader, getCardSelectionManager(extension));
+    } catch (...) {
+        mSelectedCardResource = nullptr;
+        unlock();
+        throw;
+    }
 
     if (smartCard != nullptr) {
         cardResource = getOrCreateCardResource(smartCard);
-        mSelectedCardResource = cardResource;
+        mSelectedCardResource = cardResource.get();
     }
 
     unlock();
@@ -92,57 +200,126 @@ std::shared_ptr<CardResource> ReaderManagerAdapter::matches(
 bool ReaderManagerAdapter::lock(std::shared_ptr<CardResource> cardResource,
                                 std::shared_ptr<CardResourceProfileExtension> extension)
 {
-    if (mIsBusy) {
-        if (static_cast<uint64_t>(System::currentTimeMillis()) < mLockMaxTimeMillis) {
-            return false;
-        }
+    const uint64_t now = getCurrentTimeMillis();
+
+    uint64_t lockState = mLockState.load();
+    if (lockState != UNLOCKED && now < lockState) {
+        return false;
+    }
 
+    const uint64_t newLockState = mUsageTimeoutMillis > 0 ? now + mUsageTimeoutMillis
+                                                          : LOCKED_WITHOUT_TIMEOUT;
+
+    /* Only one of the concurrent callers observing the same state acquires the reader */
+    if (!mLockState.compare_exchange_strong(lockState, newLockState)) {
+        return false;
+    }
+
+    if (lockState != UNLOCKED) {
         mLogger->warn("Reader '%' automatically unlocked due to a usage duration over than % " \
                        "milliseconds\n",
                        mReader->getName(),
                        mUsageTimeoutMillis);
+        mCumulativeBusyTimeMillis += now - mLockTimeMillis;
+        mAutoUnlockCount++;
+        recordHoldTime();
     }
 
-    if (mSelectedCardResource != cardResource) {
-        std::shared_ptr<SmartCard> smartCard =
-            extension->matches(
-                mReader,
-                SmartCardServiceProvider::getService()->createCardSelectionManager());
+    mLockTimeMillis = now;
+
+    /*
+     * The selection made on the card is kept as long as it is the one of the card resource: card
+     * resources sharing the same card and selected application are the same instance.
+     */
+    if (mSelectedCardResource != cardResource.get()) {
+        std::shared_ptr<SmartCard> smartCard = nullptr;
+        try {
+            const std::chrono::steady_clock::time_point selectionStartTime =
+                std::chrono::steady_clock::now();
+            smartCard =
+                extension->matches(mReader, getCardSelectionManager(extension));
+            mReselectionTimeHistogram.record(std::chrono::steady_clock::now() -
+                                             selectionStartTime);
+        } catch (...) {
+            /* Do not keep the reader locked on a failed selection */
+            mSelectedCardResource = nullptr;
+            unlock();
+            throw;
+        }
 
         if (!areEquals(cardResource->getSmartCard(), smartCard)) {
             mSelectedCardResource = nullptr;
+            unlock();
             throw IllegalStateException("No card is inserted or its profile does not match the " \
                                         "associated data.");
         }
 
-        mSelectedCardResource = cardResource;
+        mSelectedCardResource = cardResource.get();
+    }
+
+    mLockCount++;
+    mHoldStartTime = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    return true;
+}
+
+bool ReaderManagerAdapter::tryLock()
+{
+    const uint64_t now = getCurrentTimeMillis();
+    const uint64_t newLockState = mUsageTimeoutMillis > 0 ? now + mUsageTimeoutMillis
+                                                          : LOCKED_WITHOUT_TIMEOUT;
+
+    uint64_t lockState = UNLOCKED;
+    if (!mLockState.compare_exchange_strong(lockState, newLockState)) {
+        return false;
     }
 
-    mLockMaxTimeMillis = System::currentTimeMillis() + mUsageTimeoutMillis;
-    mIsBusy = true;
+    mLockTimeMillis = now;
 
     return true;
 }
 
 void ReaderManagerAdapter::unlock()
 {
-    mIsBusy = false;
+    if (mLockState.exchange(UNLOCKED) != UNLOCKED) {
+        const uint64_t now = getCurrentTimeMillis();
+        mCumulativeBusyTimeMillis += now - mLockTimeMillis;
+        mLastUnlockTimeMillis = now;
+        recordHoldTime();
+    }
+}
+
+void ReaderManagerAdapter::recordHoldTime()
+{
+    const std::chrono::steady_clock::rep holdStartTime = mHoldStartTime.exchange(0);
+    if (holdStartTime != 0) {
+        mHoldTimeHistogram.record(std::chrono::steady_clock::now().time_since_epoch() -
+                                  std::chrono::steady_clock::duration(holdStartTime));
+    }
 }
 
 void ReaderManagerAdapter::removeCardResource(std::shared_ptr<CardResource> cardResource)
 {
-    Arrays::remove(mCardResources, cardResource);
-    if (mSelectedCardResource == cardResource) {
-        mSelectedCardResource = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(mCardResourcesMutex);
+        Arrays::remove(mCardResources, cardResource);
     }
+
+    CardResource* selectedCardResource = cardResource.get();
+    mSelectedCardResource.compare_exchange_strong(selectedCardResource, nullptr);
 }
 
 std::shared_ptr<CardResource> ReaderManagerAdapter::getOrCreateCardResource(
     std::shared_ptr<SmartCard> smartCard)
 {
-    /* Check if an identical card resource is already created */
+    /* Check if an identical card resource is already created, comparing fingerprints first */
+    const uint64_t fingerprint = CardResource::computeFingerprint(smartCard);
+
+    const std::lock_guard<std::mutex> lock(mCardResourcesMutex);
+
     for (const auto& cardResource : mCardResources) {
-        if (areEquals(cardResource->getSmartCard(), smartCard)) {
+        if (cardResource->getFingerprint() == fingerprint &&
+            areEquals(cardResource->getSmartCard(), smartCard)) {
             return cardResource;
         }
     }
@@ -175,6 +352,36 @@ bool ReaderManagerAdapter::areEquals(const std::shared_ptr<SmartCard> s1,
     return hasSamePowerOnData && hasSameFci;
 }
 
+std::shared_ptr<CardSelectionManager> ReaderManagerAdapter::getCardSelectionManager(
+    const std::shared_ptr<CardResourceProfileExtension>& extension)
+{
+    if (!extension->isCardSelectionManagerReusable()) {
+        return SmartCardServiceProvider::getService()->createCardSelectionManager();
+    }
+
+    const std::lock_guard<std::mutex> lock(mCardSelectionManagersMutex);
+
+    CardSelectionManagerEntry& entry = mCardSelectionManagers[extension.get()];
+
+    /* An expired entry belongs to a destroyed extension, whose address has been reused */
+    if (entry.mCardSelectionManager == nullptr || entry.mExtension.expired()) {
+        entry.mExtension = extension;
+        entry.mCardSelectionManager =
+            SmartCardServiceProvider::getService()->createCardSelectionManager();
+
+        /* Forget the other extensions destroyed meanwhile (e.g. by a new configuration) */
+        for (auto it = mCardSelectionManagers.begin(); it != mCardSelectionManagers.end();) {
+            if (it->second.mExtension.expired()) {
+                it = mCardSelectionManagers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    return entry.mCardSelectionManager;
+}
+
 }
 }
 }
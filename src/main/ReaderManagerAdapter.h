@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 /* Calypsonet Terminal Reader */
 #include "CardReader.h"
@@ -26,6 +30,8 @@
 
 /* Keyple Service Resource */
 #include "CardResource.h"
+#include "CardResourceServiceMetrics.h"
+#include "LatencyHistogram.h"
 #include "ReaderConfiguratorSpi.h"
 
 
@@ -47,10 +53,32 @@ using namespace keyple::core::util::cpp;
  * <p>It contains all associated created card resources and manages concurrent access to the
  * reader's card resources so that only one card resource can be used at a time.
  *
+ * <p>The reader is acquired with a single atomic compare-and-swap on its lock state, so that
+ * concurrent threads can claim readers without any global lock.
+ *
  * @since 2.0.0
  */
 class ReaderManagerAdapter final {
 public:
+    /**
+     * Lock state value of a reader locked without usage timeout
+     *
+     * @since 2.1.0
+     */
+    static const uint64_t LOCKED_WITHOUT_TIMEOUT;
+
+    /**
+     * (package-private)<br>
+     * Gets the current time on which the lock deadlines and the lock and unlock times are based.
+     *
+     * <p>The time is read from a monotonic clock, a change of the system time neither expiring nor
+     * extending the locks.
+     *
+     * @return The number of milliseconds elapsed since an unspecified origin.
+     * @since 2.1.0
+     */
+    static uint64_t getCurrentTimeMillis();
+
     /**
      * (package-private)<br>
      * Creates a new reader manager not active by default.
@@ -87,12 +115,90 @@ public:
 
     /**
      * (package-private)<br>
-     * Gets a view of the current created card resources.
+     * Gets a copy of the current created card resources, which are modified concurrently by the
+     * probing and event threads.
      *
      * @return An empty collection if there's no card resources.
      * @since 2.0.0
      */
-    const std::vector<std::shared_ptr<CardResource>>& getCardResources() const;
+    const std::vector<std::shared_ptr<CardResource>> getCardResources() const;
+
+    /**
+     * (package-private)<br>
+     * Gets the time when the reader was unlocked for the last time.
+     *
+     * @return 0 if the reader has never been unlocked.
+     * @since 2.1.0
+     */
+    uint64_t getLastUnlockTimeMillis() const;
+
+    /**
+     * (package-private)<br>
+     * Gets the cumulative time during which the reader has been locked.
+     *
+     * @return The duration in milliseconds, not including the current lock if any.
+     * @since 2.1.0
+     */
+    uint64_t getCumulativeBusyTimeMillis() const;
+
+    /**
+     * (package-private)<br>
+     * Gets a snapshot of the metrics of the reader.
+     *
+     * @return A new instance.
+     * @since 2.1.0
+     */
+    CardResourceServiceMetrics::ReaderMetrics getMetrics() const;
+
+    /**
+     * (package-private)<br>
+     * Gets the time after which the current lock of the reader expires.
+     *
+     * @return 0 if the reader is not locked or locked without usage timeout.
+     * @since 2.1.0
+     */
+    uint64_t getLockDeadlineMillis() const;
+
+    /**
+     * (package-private)<br>
+     * Takes over the current lock of the reader if it is still the one expiring at the provided
+     * deadline, so that the reader can be released as if its card resource was released.
+     *
+     * @param deadlineMillis The deadline of the expired lock.
+     * @return False if the reader has been unlocked or locked again meanwhile.
+     * @since 2.1.0
+     */
+    bool expireLock(const uint64_t deadlineMillis);
+
+    /**
+     * (package-private)<br>
+     * Takes over the lock of the reader if it is still the provided one, so that the reader can be
+     * released by its owner only once, even if the usage timeout expires concurrently.
+     *
+     * @param lockDeadlineMillis The deadline of the owned lock, 0 if it has no usage timeout.
+     * @return False if the lock has expired or the reader has been unlocked meanwhile.
+     * @since 2.1.0
+     */
+    bool takeOverLock(const uint64_t lockDeadlineMillis);
+
+    /**
+     * (package-private)<br>
+     * Postpones the expiration of the current lock of the reader, if it has not expired yet.<br>
+     * This method is thread-safe: an expiration concurrent with the extension takes effect only
+     * if it occurs first.
+     *
+     * @param lockDeadlineMillis The deadline of the lock to extend, 0 for the current lock.
+     * @param durationMillis The duration to add.
+     * @param isFromNow True if the duration is added to the current time rather than to the
+     *        current deadline.
+     * @return The new deadline, LOCKED_WITHOUT_TIMEOUT if the reader is locked without usage
+     *         timeout, or 0 if the reader is not locked, its lock has expired or is not the
+     *         provided one.
+     * @since 2.1.0
+     */
+    uint64_t extendLock(const uint64_t lockDeadlineMillis,
+                        const uint64_t durationMillis,
+                        const bool isFromNow);
 
     /**
      * (package-private)<br>
@@ -119,7 +225,8 @@ public:
      * <p>If the card matches, then updates the current selected card resource.
      *
      * <p>In any case, invoking this method unlocks the reader due to the use of the card selection
-     * manager by the extension during the match process.
+     * manager by the extension during the match process. The reader should then be locked before,
+     * using tryLock(), if it may be in use.
      *
      * @param extension The card resource profile extension to use for matching.
      * @return Null if the inserted card does not match with the provided profile extension.
@@ -129,7 +236,8 @@ public:
 
     /**
      * (package-private)<br>
-     * Tries to lock the provided card resource if the reader is not busy.
+     * Tries to lock the provided card resource if the reader is not busy.<br>
+     * This method is thread-safe: only one of several concurrent callers can lock the reader.
      *
      * <p>If the provided card resource is not the current selected one, then tries to select it using
      * the provided card resource profile extension.
@@ -146,6 +254,16 @@ public:
     bool lock(std::shared_ptr<CardResource> cardResource,
               std::shared_ptr<CardResourceProfileExtension> extension);
 
+    /**
+     * (package-private)<br>
+     * Locks the reader if it is free, for a probing of the inserted card using matches().<br>
+     * This method is thread-safe: only one of several concurrent callers can lock the reader.
+     *
+     * @return True if the reader is locked.
+     * @since 2.1.0
+     */
+    bool tryLock();
+
     /**
      * (package-private)<br>
      * Free the reader.
@@ -184,6 +302,11 @@ private:
      */
     std::vector<std::shared_ptr<CardResource>> mCardResources;
 
+    /**
+     * Protects mCardResources
+     */
+    mutable std::mutex mCardResourcesMutex;
+
     /**
      * The reader configurator, not null if the monitoring is activated for the associated reader
      */
@@ -195,20 +318,90 @@ private:
     int mUsageTimeoutMillis;
 
     /**
-     * Indicates the time after which the reader will be automatically unlocked if a new lock is
-     * requested.
+     * Lock state value of a free reader
+     */
+    static const uint64_t UNLOCKED;
+
+    /**
+     * Packed busy flag and deadline: UNLOCKED if no card resource is actually in use, otherwise
+     * the time after which the reader will be automatically unlocked if a new lock is requested.
+     */
+    std::atomic<uint64_t> mLockState;
+
+    /**
+     * The time when the reader was locked for the last time
+     */
+    std::atomic<uint64_t> mLockTimeMillis;
+
+    /**
+     * The time when the reader was unlocked for the last time
+     */
+    std::atomic<uint64_t> mLastUnlockTimeMillis;
+
+    /**
+     * The cumulative time during which the reader has been locked
+     */
+    std::atomic<uint64_t> mCumulativeBusyTimeMillis;
+
+    /**
+     * The number of card resources of the reader allocated
+     */
+    std::atomic<uint64_t> mLockCount;
+
+    /**
+     * The number of card resources of the reader released due to the usage timeout
+     */
+    std::atomic<uint64_t> mAutoUnlockCount;
+
+    /**
+     * The time when the current card resource has been allocated, in steady clock ticks, 0 if the
+     * reader is free or locked for a probing
      */
-    uint64_t mLockMaxTimeMillis;
+    std::atomic<std::chrono::steady_clock::rep> mHoldStartTime;
 
     /**
-     * Current selected card resource
+     * The durations of the allocations of the card resources
      */
-    std::shared_ptr<CardResource> mSelectedCardResource;
+    LatencyHistogram mHoldTimeHistogram;
 
     /**
-     * Indicates if a card resource is actually in use
+     * The durations of the card selections made at allocation
      */
-    bool mIsBusy;
+    LatencyHistogram mReselectionTimeHistogram;
+
+    /**
+     * Current selected card resource.<br>
+     * Only used as an identity, never dereferenced.
+     */
+    std::atomic<CardResource*> mSelectedCardResource;
+
+    /**
+     * (private)<br>
+     * A card selection manager provided to a reusing profile extension.
+     */
+    struct CardSelectionManagerEntry {
+        /**
+         * The profile extension, expired if it has been destroyed (its address may then be reused
+         * by a new extension)
+         */
+        std::weak_ptr<CardResourceProfileExtension> mExtension;
+
+        /**
+         *
+         */
+        std::shared_ptr<CardSelectionManager> mCardSelectionManager;
+    };
+
+    /**
+     * The card selection managers already provided to the reusing profile extensions
+     */
+    std::unordered_map<const CardResourceProfileExtension*, CardSelectionManagerEntry>
+        mCardSelectionManagers;
+
+    /**
+     * Protects mCardSelectionManagers
+     */
+    std::mutex mCardSelectionManagersMutex;
 
     /**
      * Indicates if the associated reader is accepted by at least one card profile manager
@@ -234,6 +427,25 @@ private:
      * @return True if they are identical.
      */
     bool areEquals(const std::shared_ptr<SmartCard> s1, const std::shared_ptr<SmartCard> s2) const;
+
+    /**
+     * (private)<br>
+     * Gets the card selection manager to provide to the provided profile extension.
+     *
+     * <p>If the extension allows it, then the same instance is returned for all calls as long as
+     * the extension exists, otherwise a new instance is created.
+     *
+     * @param extension The card resource profile extension.
+     * @return A not null reference.
+     */
+    std::shared_ptr<CardSelectionManager> getCardSelectionManager(
+        const std::shared_ptr<CardResourceProfileExtension>& extension);
+
+    /**
+     * (private)<br>
+     * Records the duration of the current allocation, if any, which ends.
+     */
+    void recordHoldTime();
 };
 
 }
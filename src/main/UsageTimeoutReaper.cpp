@@ -0,0 +1,193 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#include "UsageTimeoutReaper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+using namespace keyple::core::util::cpp;
+
+const uint64_t UsageTimeoutReaper::TICK_MILLIS = 10;
+const int UsageTimeoutReaper::SLOT_BITS = 6;
+const uint64_t UsageTimeoutReaper::SLOT_COUNT = static_cast<uint64_t>(1) << SLOT_BITS;
+const int UsageTimeoutReaper::LEVEL_COUNT = 4;
+
+UsageTimeoutReaper::UsageTimeoutReaper(const UsageTimeoutCallback& callback)
+: mCallback(callback),
+  mSlots(LEVEL_COUNT * SLOT_COUNT),
+  mCurrentTick(getCurrentTick()),
+  mTimerCount(0),
+  mIsStopping(false)
+{
+    mThread = std::thread(&UsageTimeoutReaper::run, this);
+}
+
+UsageTimeoutReaper::~UsageTimeoutReaper()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+
+    mTimersChanged.notify_all();
+    mThread.join();
+}
+
+void UsageTimeoutReaper::schedule(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                                  std::shared_ptr<CardResource> cardResource,
+                                  const uint64_t deadlineMillis)
+{
+    Timer timer;
+    timer.mReaderManager = readerManager;
+    timer.mCardResource = cardResource;
+    timer.mDeadlineMillis = deadlineMillis;
+
+    /* The first tick starting after the deadline */
+    timer.mTick = (deadlineMillis + TICK_MILLIS - 1) / TICK_MILLIS;
+
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        /* An empty wheel is moved forward at once instead of tick by tick */
+        if (mTimerCount == 0) {
+            mCurrentTick = std::max(mCurrentTick, getCurrentTick());
+        }
+
+        timer.mTick = std::max(timer.mTick, mCurrentTick + 1);
+        addTimer(timer);
+
+        if (mTimerCount++ != 0) {
+            return;
+        }
+    }
+
+    mTimersChanged.notify_all();
+}
+
+void UsageTimeoutReaper::run()
+{
+    std::vector<Timer> expiredTimers;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (!mIsStopping) {
+        if (mTimerCount == 0) {
+            mTimersChanged.wait(lock);
+            continue;
+        }
+
+        const uint64_t currentTick = getCurrentTick();
+        if (currentTick <= mCurrentTick) {
+            mTimersChanged.wait_for(
+                lock, std::chrono::milliseconds((mCurrentTick + 1 - currentTick) * TICK_MILLIS));
+            continue;
+        }
+
+        while (mCurrentTick < currentTick) {
+            processNextTick(expiredTimers);
+        }
+
+        if (expiredTimers.empty()) {
+            continue;
+        }
+
+        mTimerCount -= expiredTimers.size();
+
+        /* The callback may lock the reader again, which schedules a new timer */
+        lock.unlock();
+
+        for (const auto& timer : expiredTimers) {
+            const std::shared_ptr<ReaderManagerAdapter> readerManager = timer.mReaderManager.lock();
+            if (readerManager == nullptr) {
+                continue;
+            }
+
+            try {
+                mCallback(readerManager, timer.mCardResource.lock(), timer.mDeadlineMillis);
+            } catch (const std::exception& e) {
+                mLogger->error("Usage timeout processing failed for reader '%': %\n",
+                               readerManager->getReader()->getName(),
+                               e.what());
+            }
+        }
+
+        expiredTimers.clear();
+
+        lock.lock();
+    }
+}
+
+void UsageTimeoutReaper::addTimer(const Timer& timer)
+{
+    /* Beyond the range of the wheel, the timer is placed again when its slot is reached */
+    const uint64_t maxTick =
+        mCurrentTick + (static_cast<uint64_t>(1) << (SLOT_BITS * LEVEL_COUNT)) - 1;
+    const uint64_t tick = std::max(mCurrentTick, std::min(timer.mTick, maxTick));
+    const uint64_t remainingTicks = tick - mCurrentTick;
+
+    int level = 0;
+    while (level < LEVEL_COUNT - 1 &&
+           remainingTicks >= static_cast<uint64_t>(1) << (SLOT_BITS * (level + 1))) {
+        level++;
+    }
+
+    const uint64_t slot = (tick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1);
+    mSlots[level * SLOT_COUNT + slot].push_back(timer);
+}
+
+void UsageTimeoutReaper::processNextTick(std::vector<Timer>& expiredTimers)
+{
+    mCurrentTick++;
+
+    /* Each time a level completes a round, the next slot of the level above is moved down */
+    for (int level = 1; level < LEVEL_COUNT; level++) {
+        if ((mCurrentTick & ((static_cast<uint64_t>(1) << (SLOT_BITS * level)) - 1)) != 0) {
+            break;
+        }
+
+        const uint64_t slot = (mCurrentTick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1);
+        std::vector<Timer> timers;
+        timers.swap(mSlots[level * SLOT_COUNT + slot]);
+        for (const auto& timer : timers) {
+            addTimer(timer);
+        }
+    }
+
+    std::vector<Timer> timers;
+    timers.swap(mSlots[mCurrentTick & (SLOT_COUNT - 1)]);
+    for (const auto& timer : timers) {
+        if (timer.mTick <= mCurrentTick) {
+            expiredTimers.push_back(timer);
+        } else {
+            addTimer(timer);
+        }
+    }
+}
+
+uint64_t UsageTimeoutReaper::getCurrentTick()
+{
+    /* The same monotonic clock as the lock deadlines */
+    return ReaderManagerAdapter::getCurrentTimeMillis() / TICK_MILLIS;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,224 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Keyple Core Util */
+#include "LoggerFactory.h"
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+#include "ReaderManagerAdapter.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+
+using namespace keyple::core::util::cpp;
+
+/**
+ * (package-private)<br>
+ * Expires the locks of the readers whose usage timeout is reached, without waiting for a new
+ * allocation attempt on them.
+ *
+ * <p>The lock deadlines are kept in a hierarchical timer wheel: each level has SLOT_COUNT slots,
+ * a slot of a level covering SLOT_COUNT slots of the level below. Scheduling and expiring a lock
+ * are then done in constant time, whatever the number of locked readers, a lock being expired at
+ * most TICK_MILLIS milliseconds after its deadline.
+ *
+ * @since 2.1.0
+ */
+class UsageTimeoutReaper final {
+public:
+    /**
+     * (package-private)<br>
+     * Callback invoked when a lock deadline is reached, with the reader manager, the locked card
+     * resource and the lock deadline.
+     *
+     * @since 2.1.0
+     */
+    using UsageTimeoutCallback = std::function<void(std::shared_ptr<ReaderManagerAdapter>,
+                                                    std::shared_ptr<CardResource>,
+                                                    const uint64_t)>;
+
+    /**
+     * (package-private)<br>
+     * Creates a new reaper and starts its thread.
+     *
+     * @param callback The callback to invoke when a lock deadline is reached.
+     * @since 2.1.0
+     */
+    explicit UsageTimeoutReaper(const UsageTimeoutCallback& callback);
+
+    /**
+     * (package-private)<br>
+     * Stops the thread of the reaper, the pending deadlines being forgotten.
+     *
+     * @since 2.1.0
+     */
+    ~UsageTimeoutReaper();
+
+    /**
+     * (package-private)<br>
+     * Schedules the expiration of the current lock of the provided reader.
+     *
+     * <p>The callback is invoked once the deadline is reached, even if the reader has been unlocked
+     * meanwhile: it is up to the callback to check that the lock is still the same.
+     *
+     * @param readerManager The locked reader manager.
+     * @param cardResource The locked card resource.
+     * @param deadlineMillis The time after which the lock is expired.
+     * @since 2.1.0
+     */
+    void schedule(std::shared_ptr<ReaderManagerAdapter> readerManager,
+                  std::shared_ptr<CardResource> cardResource,
+                  const uint64_t deadlineMillis);
+
+private:
+    /**
+     * A scheduled lock deadline
+     */
+    struct Timer {
+        /**
+         * The locked reader manager
+         */
+        std::weak_ptr<ReaderManagerAdapter> mReaderManager;
+
+        /**
+         * The locked card resource
+         */
+        std::weak_ptr<CardResource> mCardResource;
+
+        /**
+         * The time after which the lock is expired
+         */
+        uint64_t mDeadlineMillis;
+
+        /**
+         * The first tick at which the lock is expired
+         */
+        uint64_t mTick;
+    };
+
+    /**
+     *
+     */
+    const std::unique_ptr<Logger> mLogger = LoggerFactory::getLogger(typeid(UsageTimeoutReaper));
+
+    /**
+     * Duration of a tick of the wheel
+     */
+    static const uint64_t TICK_MILLIS;
+
+    /**
+     * Number of bits of a slot index
+     */
+    static const int SLOT_BITS;
+
+    /**
+     * Number of slots of each level
+     */
+    static const uint64_t SLOT_COUNT;
+
+    /**
+     * Number of levels of the wheel
+     */
+    static const int LEVEL_COUNT;
+
+    /**
+     * The callback to invoke when a lock deadline is reached
+     */
+    const UsageTimeoutCallback mCallback;
+
+    /**
+     * The slots of all levels, level after level
+     */
+    std::vector<std::vector<Timer>> mSlots;
+
+    /**
+     * The last processed tick
+     */
+    uint64_t mCurrentTick;
+
+    /**
+     * The number of scheduled timers
+     */
+    std::size_t mTimerCount;
+
+    /**
+     * Protects the wheel
+     */
+    std::mutex mMutex;
+
+    /**
+     * Notified when the first timer is scheduled or when the reaper stops
+     */
+    std::condition_variable mTimersChanged;
+
+    /**
+     * Requests the thread to end
+     */
+    bool mIsStopping;
+
+    /**
+     * The thread processing the ticks
+     */
+    std::thread mThread;
+
+    /**
+     * (private)<br>
+     * Processes the ticks as time goes by and invokes the callback for the reached deadlines.
+     */
+    void run();
+
+    /**
+     * (private)<br>
+     * Places a timer in the wheel according to its remaining number of ticks.<br>
+     * The caller must hold mMutex.
+     *
+     * @param timer The timer to place.
+     */
+    void addTimer(const Timer& timer);
+
+    /**
+     * (private)<br>
+     * Processes the next tick: moves down the timers of the upper levels reaching the lower one,
+     * and collects the expired timers.<br>
+     * The caller must hold mMutex.
+     *
+     * @param expiredTimers Where to collect the expired timers.
+     */
+    void processNextTick(std::vector<Timer>& expiredTimers);
+
+    /**
+     * (private)<br>
+     * Gets the current tick.
+     *
+     * @return The number of ticks elapsed since the origin of the lock deadlines.
+     */
+    static uint64_t getCurrentTick();
+};
+
+}
+}
+}
+}
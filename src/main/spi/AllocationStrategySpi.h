@@ -0,0 +1,72 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+namespace spi {
+
+/**
+ * Custom allocation strategy used to choose which available card resource is allocated when a card
+ * resource is requested.
+ *
+ * <p>It allows the application to implement site-specific selection rules (weighted,
+ * topology-aware, etc.) in place of the built-in strategies.
+ *
+ * @since 2.1.0
+ */
+class AllocationStrategySpi {
+public:
+    /**
+     *
+     */
+    virtual ~AllocationStrategySpi() = default;
+
+    /**
+     * Selects the card resource to try to allocate among the provided candidates.
+     *
+     * <p>The candidates are the card resources of the profile not known to be busy, in the
+     * configured order. If the reader of the selected card resource turns out to be busy, then this
+     * method is invoked again with the remaining candidates.
+     *
+     * <p>This method may be invoked concurrently, for the same or different profiles. It is
+     * invoked without any lock of the service held.
+     *
+     * <p>If this method throws an exception or returns an invalid index, then the error is logged
+     * and no card resource is allocated by the current attempt.
+     *
+     * @param cardResourceProfileName The name of the profile of the requested card resource.
+     * @param cardResources The not empty list of candidates.
+     * @return The index of the selected card resource in the provided list.
+     * @since 2.1.0
+     */
+    virtual std::size_t select(
+        const std::string& cardResourceProfileName,
+        const std::vector<std::shared_ptr<CardResource>>& cardResources) = 0;
+};
+
+}
+}
+}
+}
+}
@@ -52,6 +52,22 @@ public:
     virtual std::shared_ptr<SmartCard> matches(
         std::shared_ptr<CardReader> reader, 
         std::shared_ptr<CardSelectionManager> cardSelectionManager) = 0;
+
+    /**
+     * Indicates if the CardSelectionManager provided to matches() can be reused.
+     *
+     * <p>If true, then the same instance is provided to all the successive calls of matches() for
+     * a given reader, instead of a new one each time. The extension must then prepare its card
+     * selection scenario only the first time it receives an instance (e.g. by keeping track of the
+     * instances already prepared) and only process it on the next calls.
+     *
+     * @return False by default.
+     * @since 2.1.0
+     */
+    virtual bool isCardSelectionManagerReusable() const
+    {
+        return false;
+    }
 };
 
 }
@@ -0,0 +1,58 @@
+/**************************************************************************************************
+ * Copyright (c) 2026 Calypso Networks Association https://calypsonet.org/                        *
+ *                                                                                                *
+ * See the NOTICE file(s) distributed with this work for additional information regarding         *
+ * copyright ownership.                                                                           *
+ *                                                                                                *
+ * This program and the accompanying materials are made available under the terms of the Eclipse  *
+ * Public License 2.0 which is available at http://www.eclipse.org/legal/epl-2.0                  *
+ *                                                                                                *
+ * SPDX-License-Identifier: EPL-2.0                                                               *
+ **************************************************************************************************/
+
+
+#pragma once
+
+#include <memory>
+
+/* Keyple Service Resource */
+#include "CardResource.h"
+
+namespace keyple {
+namespace core {
+namespace service {
+namespace resource {
+namespace spi {
+
+/**
+ * Observer of the card resources whose usage timeout expired.
+ *
+ * <p>It allows the application to track the card resources not released in time by their holders.
+ *
+ * @since 2.1.0
+ */
+class UsageTimeoutObserverSpi {
+public:
+    /**
+     *
+     */
+    virtual ~UsageTimeoutObserverSpi() = default;
+
+    /**
+     * Invoked when a card resource has been automatically released because its usage timeout
+     * expired.
+     *
+     * <p>The card resource is already available for a new allocation. This method is invoked from
+     * an internal thread of the service and should return quickly.
+     *
+     * @param cardResource The card resource released.
+     * @since 2.1.0
+     */
+    virtual void onUsageTimeout(std::shared_ptr<CardResource> cardResource) = 0;
+};
+
+}
+}
+}
+}
+}